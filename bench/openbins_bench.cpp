@@ -0,0 +1,139 @@
+/**
+ * Microbenchmark of the open-bin queries of OpenBins against a naive loop.
+ *
+ *  *) naive -> plain loop over a std::vector of residual capacities
+ *  *) scan  -> scalar kernels of OpenBins
+ *  *) avx2  -> AVX2 kernels of OpenBins (only if the CPU supports AVX2)
+ *  *) tree  -> OpenBins in tree mode: segment tree for first fit, ordered set for best/worst fit
+ *
+ * All variants answer the same random queries, the results are compared against the naive loop.
+ * Reported is the time per query in nanoseconds for each number of open bins.
+ *
+ * Build from the repository root: g++ -std=c++17 -O2 -I. -o openbins_bench bench/openbins_bench.cpp
+ */
+#include "openbins.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int CAPACITY = 1000;
+const int QUERIES = 200000;
+
+int naiveFirstFit(const std::vector<int>& residual, int size)
+{
+	for (int i = 0; i < (int)residual.size(); i++)
+		if (residual[i] >= size)
+			return i;
+	return -1;
+}
+
+int naiveBestFit(const std::vector<int>& residual, int size)
+{
+	int best = -1;
+	for (int i = 0; i < (int)residual.size(); i++)
+		if (residual[i] >= size && (best < 0 || residual[i] < residual[best]))
+			best = i;
+	return best;
+}
+
+int naiveWorstFit(const std::vector<int>& residual, int size)
+{
+	int best = -1;
+	for (int i = 0; i < (int)residual.size(); i++)
+		if (residual[i] >= size && (best < 0 || residual[i] > residual[best]))
+			best = i;
+	return best;
+}
+
+// nanoseconds per query, counts the results which differ from expected (if given)
+template<typename Query>
+double measure(Query query, const std::vector<int>& sizes, const std::vector<int>& expected, int& wrong)
+{
+	std::vector<int> slots(sizes.size());
+	auto start = std::chrono::steady_clock::now();
+	for (int q = 0; q < (int)sizes.size(); q++)
+		slots[q] = query(sizes[q]);
+	std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+	for (int q = 0; q < (int)expected.size(); q++)
+		wrong += slots[q] != expected[q];
+	return d.count() / sizes.size();
+}
+
+// one line of the table: time per query of each variant, -1 if the variant is not available
+template<typename Naive, typename Scan, typename AVX2, typename Tree>
+void compare(int n, const char* name, const std::vector<int>& sizes, Naive naive, Scan scan, AVX2 avx2, Tree tree, int& wrong)
+{
+	std::vector<int> expected(sizes.size());
+	for (int q = 0; q < (int)sizes.size(); q++)
+		expected[q] = naive(sizes[q]);
+
+	double t_naive = measure(naive, sizes, std::vector<int>(), wrong);
+	double t_scan = measure(scan, sizes, expected, wrong);
+	double t_avx2 = OpenBins::vectorised() ? measure(avx2, sizes, expected, wrong) : -1;
+	double t_tree = measure(tree, sizes, expected, wrong);
+	std::printf("%8d %-6s %10.1f %10.1f %10.1f %10.1f\n", n, name, t_naive, t_scan, t_avx2, t_tree);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	std::mt19937 rng(argc > 1 ? std::atoi(argv[1]) : 1);
+	std::printf("AVX2 kernels: %s\n", OpenBins::vectorised() ? "yes" : "no (scalar only)");
+	std::printf("%8s %-6s %10s %10s %10s %10s\n", "bins", "query", "naive", "scan", "avx2", "tree");
+
+	int wrong = 0;
+	for (int n : {16, 64, 256, 1024, 2048, 8192, 65536}) {
+		// mostly full bins, every tenth bin closed (-1); the queries are item sizes
+		std::uniform_int_distribution<int> residual_dist(0, CAPACITY / 4), size_dist(1, CAPACITY / 4);
+		std::vector<int> residual(n);
+		for (int& r : residual)
+			r = rng() % 10 == 0 ? -1 : residual_dist(rng);
+		const int queries = std::max(1000, QUERIES / std::max(1, n / 64));
+		std::vector<int> sizes(queries);
+		for (int& s : sizes)
+			s = size_dist(rng);
+
+		OpenBins first_tree(OpenBins::FirstFit, 0), sorted_tree(OpenBins::BestFit, 0);
+		for (int r : residual) {
+			first_tree.add(r);
+			sorted_tree.add(r);
+		}
+
+		const int* data = residual.data();
+#if defined(OPEN_BINS_AVX2)
+		auto first_avx2 = [&](int s) { return OpenBins::firstFitAVX2(data, n, s); };
+		auto best_avx2 = [&](int s) { return OpenBins::bestFitAVX2(data, n, s); };
+		auto worst_avx2 = [&](int s) { return OpenBins::worstFitAVX2(data, n, s); };
+#else
+		auto first_avx2 = [](int) { return -1; };
+		auto best_avx2 = first_avx2, worst_avx2 = first_avx2;
+#endif
+		compare(n, "first", sizes,
+		        [&](int s) { return naiveFirstFit(residual, s); },
+		        [&](int s) { return OpenBins::firstFitScan(data, n, s); },
+		        first_avx2,
+		        [&](int s) { return first_tree.firstFit(s); }, wrong);
+		compare(n, "best", sizes,
+		        [&](int s) { return naiveBestFit(residual, s); },
+		        [&](int s) { return OpenBins::bestFitScan(data, n, s); },
+		        best_avx2,
+		        [&](int s) { return sorted_tree.bestFit(s); }, wrong);
+		compare(n, "worst", sizes,
+		        [&](int s) { return naiveWorstFit(residual, s); },
+		        [&](int s) { return OpenBins::worstFitScan(data, n, s); },
+		        worst_avx2,
+		        [&](int s) { return sorted_tree.worstFit(s); }, wrong);
+	}
+
+	if (wrong > 0) {
+		std::printf("ERROR: %d queries differ from the naive loop\n", wrong);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,491 @@
+#include "bendersformulation.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <type_traits>
+
+ILOSTLBEGIN
+
+
+/*****************************************************************************************/
+/** Lazy constraint callback *************************************************************/
+/*****************************************************************************************/
+template<typename ProbT>
+class BendersLazyCallbackI : public IloCplex::LazyConstraintCallbackI
+{
+public:
+	BendersLazyCallbackI(IloEnv env, BendersFormulation<ProbT>* formulation, const Instance<ProbT>& inst)
+		: IloCplex::LazyConstraintCallbackI(env), formulation(formulation), inst(inst) { }
+
+	IloCplex::CallbackI* duplicateCallback() const override
+	{
+		return new (getEnv()) BendersLazyCallbackI(*this);
+	}
+
+	void main() override
+	{
+		auto value = [this](const IloNumVar& var) { return (double)getValue(var); };
+		for (IloRange& cut : formulation->separate(getEnv(), inst, value)) {
+			add(cut);
+			cut.end();
+		}
+	}
+
+private:
+	BendersFormulation<ProbT>* formulation;
+	const Instance<ProbT>& inst;
+};
+
+
+
+
+/*****************************************************************************************/
+/** Master problem ***********************************************************************/
+/*****************************************************************************************/
+template<typename ProbT>
+void BendersFormulation<ProbT>::createDecisionVariables(IloEnv env, const Instance<ProbT>& inst)
+{
+	const int top = inst.m;
+
+	// decision variables y_{T}
+	y = IloNumVarArray(env, inst.n[top], 0, 1, ILOBOOL);
+	MIP_OUT(TRACE) << "added " << inst.n[top] << " y_{T} variables" << std::endl;
+
+	// decision variables z_{iT}
+	z = IloArray<IloNumVarArray>(env, inst.n[0]);
+	for (int i : inst.B[0])
+		z[i] = IloNumVarArray(env, inst.n[top], 0, 1, ILOBOOL);
+	MIP_OUT(TRACE) << "added " << inst.n[0] * inst.n[top] << " z_{iT} variables" << std::endl;
+
+	// decision variables g_{kjT}
+	int count = 0;
+	g = IloArray<IloArray<IloNumVarArray> >(env, inst.m);
+	for (int k = 1; k < inst.m; k++) {
+		g[k] = IloArray<IloNumVarArray>(env, inst.n[k]);
+		for (int j : inst.B[k]) {
+			g[k][j] = IloNumVarArray(env, inst.n[top], 0, 1, ILOBOOL);
+			count += inst.n[top];
+		}
+	}
+	MIP_OUT(TRACE) << "added " << count << " g_{kjT} variables" << std::endl;
+
+	// decision variables tau_{T} and q_{i}
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		int horizon = *std::max_element(inst.l.begin(), inst.l.end());
+		tau = IloNumVarArray(env, inst.n[top], 0, horizon, ILOFLOAT);
+		q = IloNumVarArray(env, inst.n[0], 0, IloInfinity, ILOFLOAT);
+		MIP_OUT(TRACE) << "added " << inst.n[top] << " tau_{T} and " << inst.n[0] << " q_{i} variables" << std::endl;
+	}
+}
+
+template<typename ProbT>
+void BendersFormulation<ProbT>::addConstraints(IloEnv env, IloModel model, const Instance<ProbT>& inst)
+{
+	const int top = inst.m;
+
+	// each item must be packed into exactly one top-level bin
+	for (int i : inst.B[0]) {
+		IloExpr sum(env);
+		for (int T : inst.B[top])
+			sum += z[i][T];
+		model.add(sum == 1);
+		sum.end();
+	}
+	MIP_OUT(TRACE) << "added " << inst.n[0] << " constraints such that each item is packed into exactly one top-level bin" << std::endl;
+
+	// each bin is packed into at most one top-level bin
+	int count = 0;
+	for (int k = 1; k < inst.m; k++) {
+		for (int j : inst.B[k]) {
+			IloExpr sum(env);
+			for (int T : inst.B[top])
+				sum += g[k][j][T];
+			model.add(sum <= 1);
+			sum.end();
+			count++;
+		}
+	}
+	MIP_OUT(TRACE) << "added " << count << " constraints such that each bin is packed into at most one top-level bin" << std::endl;
+
+	// items and bins can only be packed into used top-level bins
+	count = 0;
+	for (int T : inst.B[top]) {
+		for (int i : inst.B[0]) {
+			model.add(z[i][T] <= y[T]);
+			count++;
+		}
+		for (int k = 1; k < inst.m; k++) {
+			for (int j : inst.B[k]) {
+				model.add(g[k][j][T] <= y[T]);
+				count++;
+			}
+		}
+	}
+	MIP_OUT(TRACE) << "added " << count << " constraints such that only used top-level bins get content" << std::endl;
+
+	// aggregated capacities: the content of each level below T must fit into the bins of the next level below T
+	for (int T : inst.B[top]) {
+		for (int k = 1; k <= inst.m; k++) {
+			IloExpr content(env);
+			if (k == 1) {
+				for (int i : inst.B[0])
+					content += z[i][T] * inst.s[0][i];
+			} else {
+				for (int j : inst.B[k - 1])
+					content += g[k - 1][j][T] * inst.s[k - 1][j];
+			}
+
+			IloExpr capacity(env);
+			if (k == top) {
+				capacity += y[T] * inst.w[top][T];
+			} else {
+				for (int j : inst.B[k])
+					capacity += g[k][j][T] * inst.w[k][j];
+			}
+
+			model.add(content <= capacity);
+			content.end();
+			capacity.end();
+		}
+	}
+	MIP_OUT(TRACE) << "added " << inst.m * inst.n[top] << " aggregated capacity constraints" << std::endl;
+
+	// all items of a top-level bin share its start time, which must lie within their time windows
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		int horizon = *std::max_element(inst.l.begin(), inst.l.end());
+		count = 0;
+		for (int T : inst.B[top]) {
+			for (int i : inst.B[0]) {
+				model.add(tau[T] >= z[i][T] * inst.e[i]);
+				model.add(tau[T] <= inst.l[i] + horizon * (1 - z[i][T]));
+				model.add(q[i] >= inst.p * (tau[T] - inst.e[i]) - inst.p * horizon * (1 - z[i][T]));
+				count += 3;
+			}
+		}
+		MIP_OUT(TRACE) << "added " << count << " time window constraints" << std::endl;
+	}
+}
+
+template<typename ProbT>
+void BendersFormulation<ProbT>::addObjectiveFunction(IloEnv env, IloModel model, const Instance<ProbT>& inst)
+{
+	IloExpr sum(env);
+	for (int T : inst.B[inst.m])
+		sum += y[T] * inst.c[inst.m][T];
+	for (int k = 1; k < inst.m; k++)
+		for (int j : inst.B[k])
+			for (int T : inst.B[inst.m])
+				sum += g[k][j][T] * inst.c[k][j];
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		for (int i : inst.B[0])
+			sum += q[i];
+	}
+	model.add(IloMinimize(env, sum));
+	sum.end();
+}
+
+template<typename ProbT>
+void BendersFormulation<ProbT>::addUserCallbacks(IloEnv env, IloModel model, IloCplex cplex, const Instance<ProbT>& inst)
+{
+	m_cuts = 0;
+	m_cache.clear();
+	if (inst.m > 1)  // with a single level the aggregated capacities are exact
+		cplex.use(IloCplex::Callback(new (env) BendersLazyCallbackI<ProbT>(env, this, inst)));
+}
+
+
+
+
+/*****************************************************************************************/
+/** Separation ***************************************************************************/
+/*****************************************************************************************/
+template<typename ProbT>
+template<typename GetValue>
+std::vector<std::vector<int> > BendersFormulation<ProbT>::elements(const Instance<ProbT>& inst, int top, GetValue value) const
+{
+	std::vector<std::vector<int> > elems(inst.m + 1);
+	for (int i : inst.B[0])
+		if (value(z[i][top]) > 0.5)
+			elems[0].push_back(i);
+	for (int k = 1; k < inst.m; k++)
+		for (int j : inst.B[k])
+			if (value(g[k][j][top]) > 0.5)
+				elems[k].push_back(j);
+	elems[inst.m].push_back(top);
+	return elems;
+}
+
+template<typename ProbT>
+template<typename GetValue>
+std::vector<IloRange> BendersFormulation<ProbT>::separate(IloEnv env, const Instance<ProbT>& inst, GetValue value)
+{
+	// collect the subproblems of the current master solution
+	std::vector<std::vector<std::vector<int> > > subproblems;
+	std::vector<std::vector<int> > signatures;
+	for (int T : inst.B[inst.m]) {
+		if (value(y[T]) < 0.5)
+			continue;
+
+		subproblems.push_back(elements(inst, T, value));
+		std::vector<int> sig;
+		for (const auto& lvl : subproblems.back()) {
+			sig.insert(sig.end(), lvl.begin(), lvl.end());
+			sig.push_back(-1);
+		}
+		signatures.push_back(sig);
+	}
+
+	std::vector<char> solved(subproblems.size(), 0);
+	std::vector<char> feasible(subproblems.size(), 0);
+	std::vector<Packing> packings(subproblems.size());
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (int q = 0; q < (int)subproblems.size(); q++) {
+			auto it = m_cache.find(signatures[q]);
+			if (it != m_cache.end()) {
+				solved[q] = 1;
+				feasible[q] = it->second.first;
+			}
+		}
+	}
+
+	// solve the remaining subproblems in parallel
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		for (int q = next++; q < (int)subproblems.size(); q = next++) {
+			if (!solved[q])
+				feasible[q] = solveSubproblem(inst, subproblems[q], subproblems[q][inst.m][0], packings[q]);
+		}
+	};
+	std::vector<std::thread> threads;
+	for (int t = 1; t < std::min(m_threads, (int)subproblems.size()); t++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	// no-good cuts for infeasible subproblems
+	std::vector<IloRange> cuts;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (int q = 0; q < (int)subproblems.size(); q++) {
+		if (!solved[q])
+			m_cache.emplace(signatures[q], std::make_pair((bool)feasible[q], packings[q]));
+		if (feasible[q])
+			continue;
+
+		const auto& elems = subproblems[q];
+		int T = elems[inst.m][0];
+		IloExpr lhs(env);
+		for (int i : elems[0])
+			lhs -= z[i][T];
+		for (int k = 1; k < inst.m; k++) {
+			std::vector<char> in_set(inst.n[k], 0);
+			for (int j : elems[k])
+				in_set[j] = 1;
+			for (int j : inst.B[k])
+				if (!in_set[j])
+					lhs += g[k][j][T];
+		}
+		cuts.push_back(lhs >= 1 - (int)elems[0].size());
+		lhs.end();
+	}
+	m_cuts += (int)cuts.size();
+	MIP_OUT(TRACE) << "solved " << subproblems.size() << " subproblems, added " << cuts.size() << " no-good cuts" << std::endl;
+	return cuts;
+}
+
+
+
+
+/*****************************************************************************************/
+/** Subproblem ***************************************************************************/
+/*****************************************************************************************/
+template<typename ProbT>
+bool BendersFormulation<ProbT>::solveSubproblem(const Instance<MLBP>& inst, const std::vector<std::vector<int> >& elements, int top, Packing& packing)
+{
+	packing.assign(inst.m, std::vector<std::pair<int, int> >());
+
+	// first-fit decreasing level by level, proves feasibility in most cases
+	std::vector<int> cur(elements[0]);
+	bool greedy = true;
+	for (int k = 1; k <= inst.m && greedy; k++) {
+		std::sort(cur.begin(), cur.end(), [&](int a, int b) { return inst.s[k - 1][a] > inst.s[k - 1][b]; });
+		std::vector<int> parents(elements[k]);
+		std::sort(parents.begin(), parents.end(), [&](int a, int b) { return inst.w[k][a] > inst.w[k][b]; });
+
+		std::vector<int> load(parents.size(), 0);
+		for (int i : cur) {
+			int pos = 0;
+			while (pos < (int)parents.size() && load[pos] + inst.s[k - 1][i] > inst.w[k][parents[pos]])
+				pos++;
+			if (pos == (int)parents.size()) {
+				greedy = false;
+				break;
+			}
+			load[pos] += inst.s[k - 1][i];
+			packing[k - 1].emplace_back(i, parents[pos]);
+		}
+
+		cur.clear();
+		for (int pos = 0; pos < (int)parents.size(); pos++)
+			if (load[pos] > 0)
+				cur.push_back(parents[pos]);
+	}
+	if (greedy)
+		return true;
+
+	// exact check by a small MIP which uses the cheapest subset of the given bins
+	packing.assign(inst.m, std::vector<std::pair<int, int> >());
+	const auto& E = elements;
+	IloEnv env;
+	bool feasible = false;
+	try {
+		IloModel model(env);
+
+		// binary decision variables a_{kij}: element i of level k is inserted into element j of level k + 1
+		IloArray<IloArray<IloNumVarArray> > a(env, inst.m);
+		for (int k = 0; k < inst.m; k++) {
+			a[k] = IloArray<IloNumVarArray>(env, E[k].size());
+			for (int i = 0; i < (int)E[k].size(); i++)
+				a[k][i] = IloNumVarArray(env, E[k + 1].size(), 0, 1, ILOBOOL);
+		}
+
+		// binary decision variables u_{kj}: bin j of level k is used
+		IloArray<IloNumVarArray> u(env, inst.m);
+		for (int k = 1; k < inst.m; k++)
+			u[k] = IloNumVarArray(env, E[k].size(), 0, 1, ILOBOOL);
+
+		// each item is packed, each used bin is packed
+		for (int k = 0; k < inst.m; k++) {
+			for (int i = 0; i < (int)E[k].size(); i++) {
+				IloExpr sum(env);
+				for (int j = 0; j < (int)E[k + 1].size(); j++)
+					sum += a[k][i][j];
+				if (k == 0)
+					model.add(sum == 1);
+				else
+					model.add(sum == u[k][i]);
+				sum.end();
+			}
+		}
+
+		// capacities
+		for (int k = 1; k <= inst.m; k++) {
+			for (int j = 0; j < (int)E[k].size(); j++) {
+				IloExpr sum(env);
+				for (int i = 0; i < (int)E[k - 1].size(); i++)
+					sum += a[k - 1][i][j] * inst.s[k - 1][E[k - 1][i]];
+				if (k < inst.m)
+					model.add(sum <= u[k][j] * inst.w[k][E[k][j]]);
+				else
+					model.add(sum <= inst.w[k][top]);
+				sum.end();
+			}
+		}
+
+		IloExpr cost(env);
+		for (int k = 1; k < inst.m; k++)
+			for (int j = 0; j < (int)E[k].size(); j++)
+				cost += u[k][j] * inst.c[k][E[k][j]];
+		model.add(IloMinimize(env, cost));
+		cost.end();
+
+		IloCplex cplex(model);
+		cplex.setParam(IloCplex::Param::Threads, 1);
+		cplex.setOut(env.getNullStream());
+		cplex.setWarning(env.getNullStream());
+		cplex.solve();
+
+		IloAlgorithm::Status stat = cplex.getStatus();
+		if (stat == IloAlgorithm::Optimal || stat == IloAlgorithm::Feasible) {
+			feasible = true;
+
+			// follow the packing tree top-down
+			std::vector<char> keep{1};
+			for (int k = inst.m - 1; k >= 0; k--) {
+				std::vector<char> keep_lower(E[k].size(), 0);
+				for (int i = 0; i < (int)E[k].size(); i++) {
+					for (int j = 0; j < (int)E[k + 1].size(); j++) {
+						if (keep[j] && cplex.getValue(a[k][i][j]) > 0.5) {
+							keep_lower[i] = 1;
+							packing[k].emplace_back(E[k][i], E[k + 1][j]);
+						}
+					}
+				}
+				keep.swap(keep_lower);
+			}
+		} else if (stat != IloAlgorithm::Infeasible) {
+			throw std::runtime_error("Benders subproblem could not be solved");
+		}
+	} catch(IloException& e) {
+		env.end();
+		throw std::runtime_error(e.getMessage());
+	}
+	env.end();
+	return feasible;
+}
+
+
+
+
+/*****************************************************************************************/
+/** Solution *****************************************************************************/
+/*****************************************************************************************/
+template<typename ProbT>
+void BendersFormulation<ProbT>::extractSolution(IloCplex cplex, const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+
+	auto value = [&cplex](const IloNumVar& var) { return (double)cplex.getValue(var); };
+
+	sol.total_bins = 0;
+	sol.total_cost = 0;
+	for (int T : inst.B[inst.m]) {
+		if (value(y[T]) < 0.5)
+			continue;
+
+		auto elems = elements(inst, T, value);
+		if (elems[0].empty())
+			continue;
+
+		Packing packing;
+		if (!solveSubproblem(inst, elems, T, packing))
+			throw std::runtime_error("Benders master solution violates a subproblem");
+
+		sol.total_bins++;
+		sol.total_cost += inst.c[inst.m][T];
+		for (int k = 0; k < inst.m; k++) {
+			std::vector<char> used(inst.n[k + 1], 0);
+			for (const auto& a : packing[k]) {
+				sol.item_to_bins[k][a.first] = a.second;
+				if (k + 1 < inst.m && !used[a.second]) {
+					used[a.second] = 1;
+					sol.total_bins++;
+					sol.total_cost += inst.c[k + 1][a.second];
+				}
+			}
+		}
+
+		if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+			int start = std::numeric_limits<int>::min();
+			for (int i : elems[0])
+				start = std::max(start, inst.e[i]);
+			for (int i : elems[0])
+				sol.total_cost += inst.p * (start - inst.e[i]);
+		}
+	}
+	MIP_OUT(DBG) << "Benders no-good cuts: " << m_cuts << std::endl;
+}
+
+// Instantiate all required Benders formulations
+template class BendersFormulation<MLBP>;
+template class BendersFormulation<MLBPTW>;
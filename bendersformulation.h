@@ -0,0 +1,87 @@
+#ifndef __BENDERS_FORMULATION_H__
+#define __BENDERS_FORMULATION_H__
+
+#include "problems.h"
+#include "mipsolver.h"
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <algorithm>
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Logic-based Benders decomposition for the Multi-Level Bin Packing Problem
+ * (with or without time windows) which separates the top-level decisions from
+ * the packing at the lower levels.
+ *
+ * The master problem uses the following decision variables:
+ *
+ *  *) y_{T}     -> top-level bin T is used
+ *  *) z_{iT}    -> item i is packed (transitively) into top-level bin T
+ *  *) g_{kjT}   -> bin j of level k (0 < k < m) is packed (transitively) into top-level bin T
+ *  *) tau_{T}   -> start time of top-level bin T (only MLBPTW)
+ *  *) q_{i}     -> time window penalty of item i (only MLBPTW)
+ *
+ *  The lower levels are only represented by aggregated capacity constraints per top-level bin.
+ *  For each used top-level bin T the subproblem checks whether the assigned items can be packed
+ *  into the assigned bins. Since the bins are partitioned among the top-level bins, the subproblems
+ *  are independent and are solved in parallel. If a subproblem is infeasible, the lazy constraint
+ *  callback adds the combinatorial no-good cut
+ *
+ *    sum_{i in I_T} (1 - z_{iT}) + sum_{k,j not in G_{kT}} g_{kjT} >= 1
+ *
+ *  i.e. top-level bin T either loses one of its items or gets an additional bin.
+ */
+template<typename ProbT>
+class BendersFormulation : public MIPFormulation<ProbT>
+{
+public:
+	BendersFormulation(int threads = 1) : m_threads(std::max(1, threads)), m_cuts(0) { }
+
+	virtual void createDecisionVariables(IloEnv env, const Instance<ProbT>& inst) override;
+	virtual void addConstraints(IloEnv env, IloModel model, const Instance<ProbT>& inst) override;
+	virtual void addObjectiveFunction(IloEnv env, IloModel model, const Instance<ProbT>& inst) override;
+	virtual void addUserCallbacks(IloEnv env, IloModel model, IloCplex cplex, const Instance<ProbT>& inst) override;
+	virtual void extractSolution(IloCplex cplex, const Instance<ProbT>& inst, Solution<ProbT>& sol) override;
+
+	int cuts() const { return m_cuts; }  // number of added no-good cuts
+
+	// packing of the items/bins below a single top-level bin, assign[k]: (item/bin of level k, bin of level k+1)
+	typedef std::vector<std::vector<std::pair<int, int> > > Packing;
+
+	// checks if items can be packed into the given bins of each level and top-level bin top
+	static bool solveSubproblem(const Instance<MLBP>& inst, const std::vector<std::vector<int> >& elements, int top, Packing& packing);
+
+	// separates no-good cuts for the given master solution; values are read through the getter
+	template<typename GetValue>
+	std::vector<IloRange> separate(IloEnv env, const Instance<ProbT>& inst, GetValue value);
+
+private:
+	// items and bins below top-level bin T in the current master solution; index 0: items, index m: T
+	template<typename GetValue>
+	std::vector<std::vector<int> > elements(const Instance<ProbT>& inst, int top, GetValue value) const;
+
+	// binary decision variables y_{T}: top-level bin T is used
+	IloNumVarArray y;
+
+	// binary decision variables z_{iT}: item i is packed into top-level bin T
+	IloArray<IloNumVarArray> z;
+
+	// binary decision variables g_{kjT}: bin j of level k is packed into top-level bin T, index 0 is empty
+	IloArray<IloArray<IloNumVarArray> > g;
+
+	// start time tau_{T} of each top-level bin and penalty q_{i} of each item (only MLBPTW)
+	IloNumVarArray tau;
+	IloNumVarArray q;
+
+	int m_threads;  // number of threads used to solve the subproblems
+	int m_cuts;
+
+	std::mutex m_mutex;  // protects the cache, the callback may be called from several threads
+	std::map<std::vector<int>, std::pair<bool, Packing> > m_cache;  // results of already solved subproblems
+};
+
+#endif // __BENDERS_FORMULATION_H__
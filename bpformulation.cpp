@@ -3,24 +3,32 @@
 #include "instance.h"
 #include "solution.h"
 #include "users.h"
+#include "bpsolver.h"
+
+#include <algorithm>
 
 
 void BPFormulation::createDecisionVariables(IloEnv env, const Instance<BP>& inst)
 {
+	if (ub == 0)
+		computeBounds(inst);
+
 	// decision variables x_{ij}
 	x = IloArray<IloNumVarArray>(env, inst.n);  // create array of decision variables (inst.n elements)
 	for (int i : inst.I)
-		x[i] = IloNumVarArray(env, inst.n, 0, 1, ILOBOOL);
+		x[i] = IloNumVarArray(env, ub, 0, 1, ILOBOOL);
 	//                               ^     ^  ^     ^
 	//                               |     |  |     +------ variable type: ILOINT for integers
 	//                               |     |  +------------ maximum value of variables
 	//                               |     +--------------- minium value of variables
 	//                               +--------------------- number of variables
-	MIP_OUT(TRACE) << "created " << inst.n * inst.n << " x_{ij} variables" << std::endl;
+	MIP_OUT(TRACE) << "created " << inst.n * ub << " x_{ij} variables" << std::endl;
 
-	// decision variables y_j
-	y = IloNumVarArray(env, inst.n, 0, 1, ILOBOOL);
-	MIP_OUT(TRACE) << "created " << inst.n << " y_{i} variables" << std::endl;
+	// decision variables y_j, the first lb bins are used in every solution
+	y = IloNumVarArray(env, ub, 0, 1, ILOBOOL);
+	for (int j = 0; j < lb && j < ub; j++)
+		y[j].setLB(1);
+	MIP_OUT(TRACE) << "created " << ub << " y_{i} variables, " << std::min(lb, ub) << " fixed to 1" << std::endl;
 }
 
 void BPFormulation::addConstraints(IloEnv env, IloModel model, const Instance<BP>& inst)
@@ -28,7 +36,7 @@ void BPFormulation::addConstraints(IloEnv env, IloModel model, const Instance<BP
 	// each item must be inserted into exactly one bin
 	for (int i : inst.I) {
 		IloExpr sum(env);  // represents a linear expression of deicison variables and constants
-		for (int j = 0; j < inst.n; j++)
+		for (int j = 0; j < ub; j++)
 			sum += x[i][j];   // cplex overloads +,-,... operators
 		model.add(sum == 1);  // add constraint to model
 		sum.end();  // IloExpr must always call end() to free memory!
@@ -36,25 +44,25 @@ void BPFormulation::addConstraints(IloEnv env, IloModel model, const Instance<BP
 	MIP_OUT(TRACE) << "added " << inst.n << " constraints to enforce the packing of each item" << std::endl;
 
 	// the size of the content of a bin must not exceed the bin's capacity
-	for (int j = 0; j < inst.n; j++) {
+	for (int j = 0; j < ub; j++) {
 		IloExpr sum(env);
 		for (int i : inst.I)
 			sum += x[i][j] * inst.s[i];
 		model.add(sum <= y[j] * inst.smax);
 		sum.end();
 	}
-	MIP_OUT(TRACE) << "added " << inst.n << " capacity constraints" << std::endl;
+	MIP_OUT(TRACE) << "added " << ub << " capacity constraints" << std::endl;
 
 	// symmetry breaking constraints -> make sure that the j-th bin is used before the j+1-th bin is used
-	for (int j = 0; j < inst.n-1; j++)
+	for (int j = 0; j < ub-1; j++)
 		model.add(y[j] >= y[j+1]);
-	MIP_OUT(TRACE) << "added " << inst.n-1 << " symmetry breaking constraints" << std::endl;
+	MIP_OUT(TRACE) << "added " << ub-1 << " symmetry breaking constraints" << std::endl;
 }
 
 void BPFormulation::addObjectiveFunction(IloEnv env, IloModel model, const Instance<BP>& inst)
 {
 	IloExpr sum(env);
-	for (int j = 0; j < inst.n; j++)
+	for (int j = 0; j < ub; j++)
 		sum += y[j];
 	model.add(IloMinimize(env, sum));
 	sum.end();
@@ -65,7 +73,7 @@ void BPFormulation::extractSolution(IloCplex cplex, const Instance<BP>& inst, So
 	// cplex.getValue(x) returns the assigned value of decision variable x
 	sol.item_to_bins.assign(inst.n, -1);
 	sol.total_bins = 0;
-	for (int j = 0; j < inst.n; j++) {
+	for (int j = 0; j < ub; j++) {
 		if (cplex.getValue(y[j]) < 0.5)
 			break;  // valid due to symmetry breaking constraints
 
@@ -76,3 +84,21 @@ void BPFormulation::extractSolution(IloCplex cplex, const Instance<BP>& inst, So
 	}
 }
 
+bool BPFormulation::presolve(const Instance<BP>& inst, Solution<BP>& sol)
+{
+	computeBounds(inst);
+	MIP_OUT(DBG) << "bins: lower bound " << lb << ", upper bound " << ub << std::endl;
+	if (packing.empty() || lb < ub)
+		return false;
+
+	sol.item_to_bins = packing;
+	sol.total_bins = ub;
+	sol.db = lb;
+	return true;
+}
+
+void BPFormulation::computeBounds(const Instance<BP>& inst)
+{
+	lb = BPSolver::lowerBoundL2(inst.s, inst.smax);
+	ub = std::max(1, BPSolver::upperBound(inst.s, inst.smax, packing));
+}
@@ -1,6 +1,8 @@
 #ifndef __BP_FORMULATION_H__
 #define __BP_FORMULATION_H__
 
+#include <vector>
+
 #include "problems.h"
 #include "mipsolver.h"
 
@@ -18,11 +20,15 @@ template<typename> struct Solution;
  *  this formulation needs an upper bound on the number of bins
  *  in order to create enough decision variables.
  *
- *  We use a naive upper bound equal to the number of items.
+ *  The upper bound is the better one of first-fit and best-fit decreasing (the number of items
+ *  if an item does not fit). The first L2 bins (lower bound of Martello and Toth) are fixed
+ *  to be used; if both bounds meet, the heuristic solution is optimal and no model is solved.
  */
 class BPFormulation : public MIPFormulation<BP>
 {
 public:
+	BPFormulation() : ub(0), lb(0) { }
+
 	// create all required decision variables
 	virtual void createDecisionVariables(IloEnv env, const Instance<BP>& inst) override;
 
@@ -35,7 +41,18 @@ public:
 	// derive solution from the cplex object
 	virtual void extractSolution(IloCplex cplex, const Instance<BP>& inst, Solution<BP>& sol) override;
 
+	// compute the bounds, returns the heuristic solution if it is optimal
+	virtual bool presolve(const Instance<BP>& inst, Solution<BP>& sol) override;
+
 private:
+	// bounds of BPSolver
+	void computeBounds(const Instance<BP>& inst);
+
+	int ub;                    // number of bins with decision variables
+	int lb;                    // number of bins fixed to be used
+	std::vector<int> packing;  // heuristic packing with ub bins
+
+
 	// binary decision variables x_{ij}: item i is inserted into bin j (=1) or not (=0)
 	IloArray<IloNumVarArray> x;
 
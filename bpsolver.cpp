@@ -0,0 +1,411 @@
+#include "bpsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+#include "openbins.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <numeric>
+
+
+namespace {
+
+// largest sum <= capacity of a subset of sizes (bitset subset-sum)
+long maxSubsetSum(const std::vector<int>& sizes, int capacity)
+{
+	const int words = capacity / 64 + 1;
+	std::vector<uint64_t> reach(words, 0);
+	reach[0] = 1;
+	for (int v : sizes) {
+		if (v > capacity)
+			continue;
+		const int shift_words = v / 64, shift_bits = v % 64;
+		for (int w = words - 1; w >= shift_words; w--) {
+			uint64_t add = reach[w - shift_words] << shift_bits;
+			if (shift_bits > 0 && w > shift_words)
+				add |= reach[w - shift_words - 1] >> (64 - shift_bits);
+			reach[w] |= add;
+		}
+	}
+	for (int sum = capacity; sum > 0; sum--)
+		if ((reach[sum / 64] >> (sum % 64)) & 1)
+			return sum;
+	return 0;
+}
+
+// indices of sizes by decreasing size
+std::vector<int> decreasing(const std::vector<int>& sizes)
+{
+	std::vector<int> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return sizes[a] != sizes[b] ? sizes[a] > sizes[b] : a < b; });
+	return order;
+}
+
+} // namespace
+
+
+int BPSolver::lowerBoundL2(const std::vector<int>& sizes, int capacity)
+{
+	const long C = capacity;
+	std::vector<int> sorted(sizes);
+	std::sort(sorted.begin(), sorted.end());
+	const int n = (int)sorted.size();
+	std::vector<long> prefix(n + 1, 0);
+	for (int q = 0; q < n; q++)
+		prefix[q + 1] = prefix[q] + sorted[q];
+
+	// L1: total size
+	int best = (int)((prefix[n] + C - 1) / C);
+
+	// for each threshold K <= C/2 (0 and all item sizes): the items larger than C - K and the items
+	// larger than C/2 need their own bins, the items in [K, C/2] fill the remainder
+	auto first_above = [&](long v) { return (int)(std::upper_bound(sorted.begin(), sorted.end(), v) - sorted.begin()); };
+	const int half = first_above(C / 2);
+	auto evaluate = [&](long K, int from) {
+		const int large = first_above(C - K);
+		long n1 = n - large, n2 = large - half, sum2 = prefix[large] - prefix[half];
+		long rest = prefix[half] - prefix[from] - (n2 * C - sum2);
+		best = std::max(best, (int)(n1 + n2 + (rest > 0 ? (rest + C - 1) / C : 0)));
+	};
+	evaluate(0, 0);
+	for (int q = 0; q < half; q++)
+		if (q == 0 || sorted[q] != sorted[q - 1])
+			evaluate(sorted[q], q);
+	return best;
+}
+
+int BPSolver::lowerBoundL3(const std::vector<int>& sizes, int capacity)
+{
+	std::vector<char> free(sizes.size(), 1);
+	std::vector<std::vector<int> > bins;
+	std::vector<int> order = decreasing(sizes), rest;
+	int best = lowerBoundL2(sizes, capacity);
+
+	// reduce, bound the rest by L2, remove the smallest item (relaxation) and reduce again
+	for (int last = (int)order.size() - 1; ; ) {
+		reduce(sizes, capacity, free, bins);
+		rest.clear();
+		for (int i : order)
+			if (free[i])
+				rest.push_back(sizes[i]);
+		best = std::max(best, (int)bins.size() + lowerBoundL2(rest, capacity));
+		while (last >= 0 && !free[order[last]])
+			last--;
+		if (last < 0)
+			break;
+		free[order[last]] = 0;
+	}
+	return best;
+}
+
+int BPSolver::upperBound(const std::vector<int>& sizes, int capacity, std::vector<int>& assign)
+{
+	const int n = (int)sizes.size();
+	assign.clear();
+	std::vector<int> order = decreasing(sizes);
+	if (n > 0 && sizes[order[0]] > capacity)
+		return n;
+
+	int best = n + 1;
+	for (OpenBins::Query query : {OpenBins::FirstFit, OpenBins::BestFit}) {
+		OpenBins open(query);
+		std::vector<int> packing(n, -1);
+		for (int i : order) {
+			int j = query == OpenBins::FirstFit ? open.firstFit(sizes[i]) : open.bestFit(sizes[i]);
+			if (j < 0)
+				j = open.add(capacity);
+			open.set(j, open.residual(j) - sizes[i]);
+			packing[i] = j;
+		}
+		if (open.size() < best) {
+			best = open.size();
+			assign.swap(packing);
+		}
+	}
+	return std::min(best, n);
+}
+
+void BPSolver::reduce(const std::vector<int>& sizes, int capacity, std::vector<char>& free, std::vector<std::vector<int> >& bins)
+{
+	std::vector<int> order = decreasing(sizes);
+	std::vector<int> others;
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (int p = 0; p < (int)order.size(); p++) {
+			const int i = order[p];
+			if (!free[i] || sizes[i] == 0)
+				continue;
+			const int left = capacity - sizes[i];
+
+			// largest item fitting with i and the two smallest items
+			int j = -1, t1 = -1, t2 = -1;
+			for (int q = 0; q < (int)order.size() && j < 0; q++)
+				if (q != p && free[order[q]] && sizes[order[q]] > 0 && sizes[order[q]] <= left)
+					j = order[q];
+			for (int q = (int)order.size() - 1; q >= 0 && t2 < 0; q--)
+				if (q != p && free[order[q]] && sizes[order[q]] > 0)
+					(t1 < 0 ? t1 : t2) = order[q];
+
+			bool dominant;
+			if (j < 0 || sizes[j] == left || t2 < 0 || sizes[t1] + sizes[t2] > left)
+				dominant = true;   // nothing fits, perfect fit or at most one item fits
+			else if (j != t1 && sizes[j] + sizes[t1] <= left)
+				dominant = false;  // j and the smallest item fit
+			else {
+				// no subset of the other items may have a size in (s_j, left]
+				others.clear();
+				for (int q = 0; q < (int)order.size(); q++)
+					if (q != p && free[order[q]] && sizes[order[q]] > 0)
+						others.push_back(sizes[order[q]]);
+				dominant = maxSubsetSum(others, left) <= sizes[j];
+			}
+			if (!dominant)
+				continue;
+
+			free[i] = 0;
+			bins.push_back(std::vector<int>(1, i));
+			if (j >= 0) {
+				free[j] = 0;
+				bins.back().push_back(j);
+			}
+			changed = true;
+		}
+	}
+}
+
+BPSolver::Status BPSolver::run(const Instance<BP>& inst, Solution<BP>& sol)
+{
+	m_start = std::chrono::steady_clock::now();
+	m_nodes = 0;
+	m_aborted = false;
+	m_truncated = false;
+
+	for (int i : inst.I)
+		if (inst.s[i] > inst.smax) {
+			HEU_OUT(WARN) << "BP: item " << i << " is larger than the bins" << std::endl;
+			return Infeasible;
+		}
+
+	// items of size 0 fit into any bin: they are left out of the bounds, the reduction and the search
+	// and packed into bin 0 (at least one bin if there are any)
+	std::vector<int> items, sizes;
+	for (int i : inst.I)
+		if (inst.s[i] > 0) {
+			items.push_back(i);
+			sizes.push_back(inst.s[i]);
+		}
+	const int n = (int)items.size();
+	const int least = n < inst.n ? 1 : 0;
+	auto store = [&](const std::vector<int>& packing, int bins) {
+		sol.item_to_bins.assign(inst.n, 0);
+		for (int t = 0; t < n; t++)
+			sol.item_to_bins[items[t]] = packing[t];
+		sol.total_bins = std::max(bins, least);
+	};
+
+	// upper bound and lower bound on the original instance
+	std::vector<int> assign;
+	int ub = std::max(upperBound(sizes, inst.smax, assign), least);
+	int lb = std::max(lowerBoundL3(sizes, inst.smax), least);
+	store(assign, ub);
+	sol.db = lb;
+	HEU_OUT(INFO) << "BP: lower bound " << lb << ", upper bound " << ub << std::endl;
+	if (lb >= ub) {
+		sol.db = ub;
+		return Optimal;
+	}
+
+	// search on the reduced instance, the items are renumbered by decreasing size
+	std::vector<int> order = decreasing(sizes);
+	m_sizes.resize(n);
+	for (int p = 0; p < n; p++)
+		m_sizes[p] = sizes[order[p]];
+	m_capacity = inst.smax;
+	m_free.assign(n, 1);
+	m_bins.clear();
+	reduce(m_sizes, m_capacity, m_free, m_bins);
+	m_remaining = (int)std::count(m_free.begin(), m_free.end(), 1);
+	m_nogoods.clear();
+	m_lower = lb;
+	m_best = ub;
+	m_best_bins.clear();
+	HEU_OUT(DBG) << "BP: reduction fixed " << m_bins.size() << " bins, " << m_remaining << " items left" << std::endl;
+
+	search((int)m_bins.size());
+
+	if (!m_best_bins.empty()) {
+		std::vector<int> packing(n, -1);
+		for (int b = 0; b < (int)m_best_bins.size(); b++)
+			for (int p : m_best_bins[b])
+				packing[order[p]] = b;
+		store(packing, m_best);
+	}
+
+	if (!m_aborted && (!m_truncated || sol.total_bins <= lb)) {
+		sol.db = sol.total_bins;
+		HEU_OUT(INFO) << "BP: optimal number of bins " << sol.total_bins << " after " << m_nodes << " nodes" << std::endl;
+		return Optimal;
+	}
+	HEU_OUT(INFO) << "BP: " << (m_aborted ? "time limit reached" : "completions cut off") << " after " << m_nodes << " nodes, " << sol.total_bins << " bins" << std::endl;
+	return Feasible;
+}
+
+bool BPSolver::timeout(long count)
+{
+	if (m_aborted)
+		return true;
+	if (m_time_limit > 0 && (count & 1023) == 0) {
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - m_start;
+		m_aborted = d.count() >= m_time_limit;
+	}
+	return m_aborted;
+}
+
+int BPSolver::bound() const
+{
+	std::vector<int> rest;
+	rest.reserve(m_remaining);
+	for (int p = 0; p < (int)m_sizes.size(); p++)
+		if (m_free[p])
+			rest.push_back(m_sizes[p]);
+	return lowerBoundL2(rest, m_capacity);
+}
+
+void BPSolver::search(int used)
+{
+	m_nodes++;
+	if (timeout(m_nodes) || m_best <= m_lower)
+		return;
+	if (m_remaining == 0) {
+		if (used < m_best) {
+			m_best = used;
+			m_best_bins = m_bins;
+		}
+		return;
+	}
+	if (used + bound() >= m_best)
+		return;
+
+	// the bin of the largest free item is completed
+	const int x = (int)(std::find(m_free.begin(), m_free.end(), 1) - m_free.begin());
+	m_free[x] = 0;
+	m_remaining--;
+	std::vector<Completion> comps;
+	completions(x, comps);
+
+	const size_t nogoods = m_nogoods.size();
+	for (const Completion& c : comps) {
+		for (int p : c.items)
+			m_free[p] = 0;
+		m_remaining -= (int)c.items.size();
+		m_bins.push_back(c.items);
+		m_bins.back().push_back(x);
+
+		search(used + 1);
+
+		m_bins.pop_back();
+		m_remaining += (int)c.items.size();
+		for (int p : c.items)
+			m_free[p] = 1;
+		if (m_aborted || m_best <= m_lower || used + 1 >= m_best)
+			break;
+		if (!c.items.empty())
+			m_nogoods.push_back(c.items);  // completions are tried by decreasing size
+	}
+	m_nogoods.resize(nogoods);
+
+	m_free[x] = 1;
+	m_remaining++;
+}
+
+void BPSolver::completions(int x, std::vector<Completion>& out)
+{
+	out.clear();
+	const int left = m_capacity - m_sizes[x];
+	std::vector<int> cand;
+	for (int p = 0; p < (int)m_sizes.size(); p++)
+		if (m_free[p] && m_sizes[p] <= left)
+			cand.push_back(p);
+
+	std::vector<char> chosen(m_sizes.size(), 0);
+	std::vector<int> items;
+
+	// suffix[q]: total size of the candidates q, q+1, ...
+	std::vector<long> suffix(cand.size() + 1, 0);
+	for (int q = (int)cand.size() - 1; q >= 0; q--)
+		suffix[q] = suffix[q + 1] + m_sizes[cand[q]];
+	long steps = 0;
+
+	// undominated: maximal, no excluded item replaces one smaller chosen item or two chosen items of at most its size,
+	// no nogood is packed completely
+	auto undominated = [&](int residual) {
+		for (int q = (int)cand.size() - 1; q >= 0; q--)
+			if (!chosen[cand[q]]) {
+				if (m_sizes[cand[q]] <= residual)
+					return false;
+				break;
+			}
+		for (int e : cand) {
+			if (chosen[e])
+				continue;
+			const int se = m_sizes[e];
+			for (int a = 0; a < (int)items.size(); a++) {
+				const int sa = m_sizes[items[a]];
+				if (sa < se && se <= sa + residual)
+					return false;
+				for (int b = a + 1; b < (int)items.size(); b++) {
+					const int sab = sa + m_sizes[items[b]];
+					if (sab <= se && se <= sab + residual)
+						return false;
+				}
+			}
+		}
+		chosen[x] = 1;
+		bool ok = true;
+		for (const std::vector<int>& nogood : m_nogoods)
+			if (std::all_of(nogood.begin(), nogood.end(), [&](int p) { return chosen[p] != 0; })) {
+				ok = false;
+				break;
+			}
+		chosen[x] = 0;
+		return ok;
+	};
+
+	// enumerate the subsets of the candidates, identical sizes are chosen in index order only; smallest: size of the
+	// smallest excluded candidate, a completion is maximal only if its residual is below it, so a subtree is pruned
+	// as soon as adding all remaining candidates can not bring the residual below smallest
+	bool full = false;
+	auto generate = [&](auto& self, int from, int residual, long size, int smallest) -> void {
+		if (timeout(++steps))
+			return;
+		if (residual < smallest && undominated(residual)) {
+			out.push_back(Completion{items, size});
+			if ((int)out.size() >= MAX_COMPLETIONS) {
+				m_truncated = full = true;
+				return;
+			}
+		}
+		for (int q = from; q < (int)cand.size(); q++) {
+			const int p = cand[q];
+			const int excluded = q > from ? std::min(smallest, m_sizes[cand[q - 1]]) : smallest;
+			if (residual - suffix[q] >= excluded)
+				break;  // the residual only grows with q while the smallest excluded size only shrinks
+			if (m_sizes[p] > residual || (q > from && m_sizes[p] == m_sizes[cand[q - 1]]))
+				continue;
+			chosen[p] = 1;
+			items.push_back(p);
+			self(self, q + 1, residual - m_sizes[p], size + m_sizes[p], excluded);
+			items.pop_back();
+			chosen[p] = 0;
+			if (m_aborted || full)
+				return;
+		}
+	};
+	generate(generate, 0, left, 0, INT_MAX);
+
+	std::stable_sort(out.begin(), out.end(), [](const Completion& a, const Completion& b) { return a.size > b.size; });
+}
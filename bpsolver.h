@@ -0,0 +1,91 @@
+#ifndef __BP_SOLVER_H__
+#define __BP_SOLVER_H__
+
+#include <vector>
+#include <chrono>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Native exact solver for the Bin Packing Problem (no CPLEX).
+ *
+ *  *) reduction   -> Martello-Toth reduction: the largest free item i is packed with the largest item j that
+ *                    fits if no other subset of items fitting with i has a larger size than j (checked by a
+ *                    bitset subset-sum), the fixed bins are removed from the instance
+ *  *) bounds      -> L2 of Martello and Toth, L3 (reduction alternating with the removal of the smallest item),
+ *                    first-fit/best-fit decreasing as upper bound
+ *  *) search      -> bin completion (Korf): each node fills the bin of the largest free item with an undominated
+ *                    maximal completion, completions are tried by decreasing size and pruned by L2; the
+ *                    generation skips subsets which can not be extended to a maximal completion and stops
+ *                    after MAX_COMPLETIONS completions of a node (the search is then no longer exhaustive)
+ *  *) nogoods     -> after the completion R_j of a node was explored, the subtrees of its later siblings
+ *                    must not pack all items of R_j into one bin
+ *
+ *  Items of size 0 are packed into the first bin after the other items are solved.
+ *
+ *  Status Optimal if the search is completed (sol.db = sol.total_bins), Feasible on timeout or if the completions
+ *  of a node were cut off without reaching the lower bound (sol.db = L3).
+ */
+class BPSolver : public SolverStatus
+{
+public:
+	// largest number of completions of a node
+	static const int MAX_COMPLETIONS = 2000;
+
+	BPSolver() : m_time_limit(0), m_nodes(0) { }
+
+	void setTimeLimit(int time) { m_time_limit = time; }  // in seconds -> 0: no time limit
+
+	Status run(const Instance<BP>& inst, Solution<BP>& sol);
+
+	long nodes() const { return m_nodes; }  // number of search nodes from last run(...) call
+
+	// lower bound L2 of Martello and Toth
+	static int lowerBoundL2(const std::vector<int>& sizes, int capacity);
+
+	// lower bound L3 of Martello and Toth
+	static int lowerBoundL3(const std::vector<int>& sizes, int capacity);
+
+	// better one of first-fit and best-fit decreasing, assign[i]: bin of item i; number of items if an item does not fit
+	static int upperBound(const std::vector<int>& sizes, int capacity, std::vector<int>& assign);
+
+	// Martello-Toth reduction of the free items (free[i] != 0), fixed bins are appended to bins and their items set to not free;
+	// items of size 0 are neither fixed nor counted as items fitting into a bin
+	static void reduce(const std::vector<int>& sizes, int capacity, std::vector<char>& free, std::vector<std::vector<int> >& bins);
+
+private:
+	struct Completion
+	{
+		std::vector<int> items;  // items of the bin except the largest one
+		long size;
+	};
+
+	void search(int used);
+	void completions(int x, std::vector<Completion>& out);
+	int bound() const;
+	bool timeout(long count);  // checks the time limit every 1024 counts
+
+	// free items sorted by decreasing size (indices into m_sizes), capacity
+	std::vector<int> m_sizes;
+	int m_capacity;
+	std::vector<char> m_free;
+	int m_remaining;
+
+	std::vector<std::vector<int> > m_bins;      // bins of the current path (items except the largest one first)
+	std::vector<std::vector<int> > m_nogoods;
+	int m_lower;                                // lower bound of the instance, the search stops when it is reached
+	int m_best;
+	std::vector<std::vector<int> > m_best_bins;
+
+	int m_time_limit;
+	long m_nodes;
+	bool m_aborted;
+	bool m_truncated;  // the completions of a node were cut off at MAX_COMPLETIONS
+	std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // __BP_SOLVER_H__
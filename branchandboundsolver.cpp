@@ -0,0 +1,529 @@
+#include "branchandboundsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "users.h"
+#include "fitdecreasingsolver.h"
+#include "mlbptwsweepsolver.h"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+
+namespace {
+
+// intersection of the time windows of a subtree, number of items and sum of e
+struct Window
+{
+	int e;
+	int l;
+	long count;
+	long sum;
+
+	bool operator==(const Window& other) const { return e == other.e && l == other.l && count == other.count && sum == other.sum; }
+};
+
+const Window NO_WINDOW{INT_MIN, INT_MAX, 0, 0};
+
+Window combine(const Window& a, const Window& b)
+{
+	return Window{std::max(a.e, b.e), std::min(a.l, b.l), a.count + b.count, a.sum + b.sum};
+}
+
+// partial solution: levels < k are packed, the elements of level k-1 are packed into bins of level k
+struct Node
+{
+	int k;
+	int q;                                  // position of the next element
+	std::vector<int> elems;                 // elements of level k-1 by decreasing size
+	std::vector<Window> ewin;               // time windows of the elements (only MLBPTW)
+	std::vector<std::vector<int> > assign;  // item_to_bins
+	std::vector<int> opened;                // opened bins of level k in opening order
+	std::vector<int> residual;              // residual capacity of each bin of level k
+	std::vector<int> slot;                  // opening rank of each bin of level k, -1: unused
+	std::vector<Window> bwin;               // time windows of the bins of level k (only MLBPTW)
+	std::vector<int> type_used;             // number of opened bins of each type of level k
+	long cost;                              // opened bins of the levels 1...k
+	long penalty;                           // waiting penalty of the opened bins of level k and the remaining elements
+	long free;                              // total residual capacity of the opened bins of level k
+	long remaining;                         // total size of the elements q...
+	long opened_size;                       // total size of the opened bins of level k as elements of level k+1
+};
+
+// deque of subtrees: the owner works on the newest, thieves take the oldest (closest to the root)
+class TaskDeque
+{
+public:
+	void push(Node&& node)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(node));
+	}
+
+	bool pop(Node& node)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (tasks.empty())
+			return false;
+		node = std::move(tasks.back());
+		tasks.pop_back();
+		return true;
+	}
+
+	bool steal(Node& node)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (tasks.empty())
+			return false;
+		node = std::move(tasks.front());
+		tasks.pop_front();
+		return true;
+	}
+
+private:
+	std::deque<Node> tasks;
+	std::mutex mutex;
+};
+
+// branching decision: element into bin b, fresh: b is opened (of type t)
+struct Option
+{
+	int b;
+	bool fresh;
+	int type;
+};
+
+template<typename ProbT>
+class Search
+{
+public:
+	Search(const Instance<ProbT>& inst, int threads, int time_limit, const Solution<ProbT>& incumbent, long best)
+		: inst(inst), m(inst.m), threads(threads), time_limit(time_limit), best(best), best_sol(incumbent), found(false), stop(false), timeout(false), pending(0), idle(0), nodes(0), deques(threads)
+	{
+		// bins of identical capacity, cost and size are interchangeable
+		type_bins.resize(m + 1);
+		rho.assign(m + 1, 0.0);
+		sigma.assign(m + 1, 0.0);
+		for (int k : inst.M) {
+			std::map<std::tuple<int, int, int>, int> types;
+			rho[k] = sigma[k] = INFINITY;
+			for (int j : inst.B[k]) {
+				auto key = std::make_tuple(inst.w[k][j], inst.c[k][j], k < m ? inst.s[k][j] : 0);
+				auto it = types.find(key);
+				if (it == types.end()) {
+					it = types.emplace(key, (int)type_bins[k].size()).first;
+					type_bins[k].push_back(std::vector<int>());
+				}
+				type_bins[k][it->second].push_back(j);
+				rho[k] = std::min(rho[k], (double)inst.c[k][j] / std::max(1, inst.w[k][j]));
+				if (k < m)
+					sigma[k] = std::min(sigma[k], (double)inst.s[k][j] / std::max(1, inst.w[k][j]));
+			}
+			if (k == m)
+				sigma[k] = 0.0;
+		}
+	}
+
+	void run()
+	{
+		start = std::chrono::steady_clock::now();
+
+		Node root;
+		root.k = 0;
+		root.assign.resize(m);
+		for (int k = 0; k < m; k++)
+			root.assign[k].assign(inst.n[k], -1);
+		root.cost = 0;
+		std::vector<int> items(inst.B[0]);
+		std::vector<Window> windows(inst.n[0], NO_WINDOW);
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			for (int i : inst.B[0])
+				windows[i] = Window{inst.e[i], inst.l[i], 1, inst.e[i]};
+		startLevel(root, items, windows);
+
+		pending = 1;
+		deques[0].push(std::move(root));
+
+		std::vector<std::thread> workers;
+		for (int t = 1; t < threads; t++)
+			workers.emplace_back(&Search::worker, this, t);
+		worker(0);
+		for (auto& thread : workers)
+			thread.join();
+	}
+
+	const Instance<ProbT>& inst;
+	const int m;
+	const int threads;
+	const int time_limit;
+
+	std::atomic<long> best;
+	Solution<ProbT> best_sol;
+	bool found;  // best_sol was improved by the search
+	std::atomic<bool> stop;
+	std::atomic<bool> timeout;
+	std::atomic<long> pending;  // subtrees not finished yet
+	std::atomic<int> idle;      // threads looking for work
+	std::atomic<long> nodes;
+
+private:
+	void worker(int t)
+	{
+		long count = 0;
+		bool waiting = false;
+		Node node;
+		while (!stop) {
+			bool got = deques[t].pop(node);
+			for (int v = 1; !got && v < threads; v++)
+				got = deques[(t + v) % threads].steal(node);
+			if (got) {
+				if (waiting) {
+					waiting = false;
+					idle--;
+				}
+				dfs(node, deques[t], count);
+				pending--;
+				continue;
+			}
+			if (pending == 0)
+				break;
+			if (!waiting) {
+				waiting = true;
+				idle++;
+			}
+			std::this_thread::yield();
+		}
+		if (waiting)
+			idle--;
+		nodes += count;
+	}
+
+	// elements of level k (the given ones) are packed into bins of level k+1
+	void startLevel(Node& node, const std::vector<int>& elems, const std::vector<Window>& windows)
+	{
+		const int k = ++node.k;
+		const std::vector<int>& size = inst.s[k - 1];
+		node.q = 0;
+		node.elems = elems;
+		std::sort(node.elems.begin(), node.elems.end(), [&](int a, int b) {
+			if (size[a] != size[b])
+				return size[a] > size[b];
+			if (windows[a].e != windows[b].e)
+				return windows[a].e < windows[b].e;
+			return a < b;
+		});
+		node.ewin.resize(node.elems.size());
+		node.penalty = 0;
+		node.remaining = 0;
+		for (int q = 0; q < (int)node.elems.size(); q++) {
+			node.ewin[q] = windows[node.elems[q]];
+			node.penalty += penaltyOf(node.ewin[q]);
+			node.remaining += size[node.elems[q]];
+		}
+		node.opened.clear();
+		node.residual.assign(inst.n[k], 0);
+		node.slot.assign(inst.n[k], -1);
+		node.bwin.assign(std::is_same<ProbT, MLBPTW>::value ? inst.n[k] : 0, NO_WINDOW);
+		node.type_used.assign(type_bins[k].size(), 0);
+		node.free = 0;
+		node.opened_size = 0;
+	}
+
+	long penaltyOf(const Window& w) const
+	{
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			return w.count == 0 ? 0 : (long)inst.p * (w.count * w.e - w.sum);
+		return 0;
+	}
+
+	long bound(const Node& node) const
+	{
+		// missing capacity of the current level, all bins of the current level need capacity on the upper levels
+		double extra = 0;
+		double missing = std::max(0L, node.remaining - node.free);
+		extra += rho[node.k] * missing;
+		double size = node.opened_size + sigma[node.k] * missing;
+		for (int j = node.k + 1; j <= m; j++) {
+			extra += rho[j] * size;
+			size *= sigma[j];
+		}
+		return node.cost + node.penalty + (long)std::ceil(extra - 1e-6);
+	}
+
+	void options(const Node& node, std::vector<Option>& out) const
+	{
+		const int k = node.k;
+		const int x = node.elems[node.q];
+		const int size = inst.s[k - 1][x];
+		const Window& w = node.ewin[node.q];
+		out.clear();
+
+		// identical consecutive elements: non-decreasing opening rank
+		int min_slot = -1;
+		if (node.q > 0) {
+			int y = node.elems[node.q - 1];
+			if (inst.s[k - 1][y] == size && node.ewin[node.q - 1] == w)
+				min_slot = node.slot[node.assign[k - 1][y]];
+		}
+
+		for (int b : node.opened) {
+			if (node.slot[b] < min_slot || node.residual[b] < size)
+				continue;
+			if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+				if (std::max(node.bwin[b].e, w.e) > std::min(node.bwin[b].l, w.l))
+					continue;
+			} else if (node.residual[b] == size) {
+				// filling an opened bin exactly dominates all other options
+				out.assign(1, Option{b, false, -1});
+				return;
+			}
+			out.push_back(Option{b, false, -1});
+		}
+		std::sort(out.begin(), out.end(), [&](const Option& a, const Option& b) { return node.residual[a.b] < node.residual[b.b]; });
+
+		size_t existing = out.size();
+		for (int t = 0; t < (int)type_bins[k].size(); t++) {
+			if (node.type_used[t] == (int)type_bins[k][t].size())
+				continue;
+			int b = type_bins[k][t][node.type_used[t]];
+			if (inst.w[k][b] >= size)
+				out.push_back(Option{b, true, t});
+		}
+		std::sort(out.begin() + existing, out.end(), [&](const Option& a, const Option& b) {
+			return (double)inst.c[k][a.b] / inst.w[k][a.b] < (double)inst.c[k][b.b] / inst.w[k][b.b];
+		});
+	}
+
+	void apply(Node& node, const Option& opt, Window& old) const
+	{
+		const int k = node.k;
+		const int x = node.elems[node.q];
+		const int size = inst.s[k - 1][x];
+		const int b = opt.b;
+		if (opt.fresh) {
+			node.slot[b] = (int)node.opened.size();
+			node.opened.push_back(b);
+			node.residual[b] = inst.w[k][b];
+			node.type_used[opt.type]++;
+			node.cost += inst.c[k][b];
+			node.free += inst.w[k][b];
+			node.opened_size += k < m ? inst.s[k][b] : 0;
+		}
+		if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+			old = node.bwin[b];
+			node.penalty -= penaltyOf(old) + penaltyOf(node.ewin[node.q]);
+			node.bwin[b] = combine(old, node.ewin[node.q]);
+			node.penalty += penaltyOf(node.bwin[b]);
+		}
+		node.residual[b] -= size;
+		node.free -= size;
+		node.remaining -= size;
+		node.assign[k - 1][x] = b;
+		node.q++;
+	}
+
+	void undo(Node& node, const Option& opt, const Window& old) const
+	{
+		node.q--;
+		const int k = node.k;
+		const int x = node.elems[node.q];
+		const int size = inst.s[k - 1][x];
+		const int b = opt.b;
+		node.assign[k - 1][x] = -1;
+		node.residual[b] += size;
+		node.free += size;
+		node.remaining += size;
+		if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+			node.penalty -= penaltyOf(node.bwin[b]);
+			node.bwin[b] = old;
+			node.penalty += penaltyOf(old) + penaltyOf(node.ewin[node.q]);
+		}
+		if (opt.fresh) {
+			node.slot[b] = -1;
+			node.opened.pop_back();
+			node.type_used[opt.type]--;
+			node.cost -= inst.c[k][b];
+			node.free -= inst.w[k][b];
+			node.opened_size -= k < m ? inst.s[k][b] : 0;
+		}
+	}
+
+	void dfs(Node& node, TaskDeque& own, long& count)
+	{
+		if (stop)
+			return;
+		if ((++count & 1023) == 0 && time_limit > 0) {
+			std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+			if (d.count() >= time_limit) {
+				timeout = true;
+				stop = true;
+				return;
+			}
+		}
+		if (bound(node) >= best)
+			return;
+
+		if (node.q == (int)node.elems.size()) {
+			if (node.k == m) {
+				// complete solution, the penalty of the top-level bins is exact
+				std::lock_guard<std::mutex> lock(mutex);
+				if (node.cost + node.penalty < best) {
+					best = node.cost + node.penalty;
+					for (int k = 0; k < m; k++)
+						best_sol.item_to_bins[k] = node.assign[k];
+					best_sol.total_cost = (int)best;
+					best_sol.total_bins = 0;
+					found = true;
+				}
+				return;
+			}
+
+			// the opened bins become the elements of the next level
+			Node saved;
+			std::swap(saved.elems, node.elems);
+			std::swap(saved.ewin, node.ewin);
+			std::swap(saved.opened, node.opened);
+			std::swap(saved.residual, node.residual);
+			std::swap(saved.slot, node.slot);
+			std::swap(saved.bwin, node.bwin);
+			std::swap(saved.type_used, node.type_used);
+			saved.k = node.k;
+			saved.q = node.q;
+			saved.penalty = node.penalty;
+			saved.free = node.free;
+			saved.remaining = node.remaining;
+			saved.opened_size = node.opened_size;
+
+			std::vector<Window> windows(inst.n[node.k], NO_WINDOW);
+			if constexpr (std::is_same<ProbT, MLBPTW>::value)
+				for (int b : saved.opened)
+					windows[b] = saved.bwin[b];
+			startLevel(node, saved.opened, windows);
+			dfs(node, own, count);
+
+			std::swap(saved.elems, node.elems);
+			std::swap(saved.ewin, node.ewin);
+			std::swap(saved.opened, node.opened);
+			std::swap(saved.residual, node.residual);
+			std::swap(saved.slot, node.slot);
+			std::swap(saved.bwin, node.bwin);
+			std::swap(saved.type_used, node.type_used);
+			node.k = saved.k;
+			node.q = saved.q;
+			node.penalty = saved.penalty;
+			node.free = saved.free;
+			node.remaining = saved.remaining;
+			node.opened_size = saved.opened_size;
+			return;
+		}
+
+		std::vector<Option> opts;
+		options(node, opts);
+		Window old = NO_WINDOW;
+
+		// other threads are idle: all but the first subtree are shared
+		size_t last = opts.size();
+		if (idle > 0 && opts.size() > 1 && node.elems.size() - node.q > 2) {
+			pending += (long)opts.size() - 1;
+			for (size_t o = 1; o < opts.size(); o++) {
+				apply(node, opts[o], old);
+				own.push(Node(node));
+				undo(node, opts[o], old);
+			}
+			last = 1;
+		}
+
+		for (size_t o = 0; o < last && !stop; o++) {
+			apply(node, opts[o], old);
+			dfs(node, own, count);
+			undo(node, opts[o], old);
+		}
+	}
+
+	std::vector<std::vector<std::vector<int> > > type_bins;  // type_bins[k][t]: bins of type t (increasing index)
+	std::vector<double> rho;    // smallest cost per capacity of each level
+	std::vector<double> sigma;  // smallest size per capacity of each level (< m)
+
+	std::chrono::steady_clock::time_point start;
+	std::vector<TaskDeque> deques;
+	std::mutex mutex;
+};
+
+} // namespace
+
+
+template<typename ProbT>
+typename BranchAndBoundSolver<ProbT>::Status BranchAndBoundSolver<ProbT>::run(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	// initial incumbent: start solution and fit decreasing (sweep for MLBPTW)
+	Solution<ProbT> incumbent(sol);
+	long best = SolutionVerifier<ProbT>::verify(inst, sol) ? sol.total_cost : LONG_MAX;
+	bool improved = false;
+	std::vector<Solution<ProbT> > starts;
+	for (auto variant : {FitDecreasingSolver<ProbT>::BestFit, FitDecreasingSolver<ProbT>::FirstFit}) {
+		Solution<ProbT> cand(inst);
+		if (FitDecreasingSolver<ProbT>(variant).run(inst, cand) == Feasible)
+			starts.push_back(cand);
+	}
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		Solution<ProbT> cand(inst);
+		if (MLBPTWSweepSolver().run(inst, cand) == Feasible)
+			starts.push_back(cand);
+	}
+	for (const Solution<ProbT>& cand : starts)
+		if (cand.total_cost < best) {
+			best = cand.total_cost;
+			incumbent = cand;
+			improved = true;
+		}
+
+	Search<ProbT> search(inst, m_threads, m_time_limit, incumbent, best);
+	search.run();
+	m_nodes = search.nodes;
+
+	if (search.found) {
+		incumbent = search.best_sol;
+		incumbent.total_bins = 0;
+		for (int k = 0; k < inst.m; k++) {
+			std::vector<char> used(inst.n[k + 1], 0);
+			for (int b : incumbent.item_to_bins[k])
+				if (b >= 0 && !used[b]) {
+					used[b] = 1;
+					incumbent.total_bins++;
+				}
+		}
+		improved = true;
+	}
+	if (improved) {
+		auto db = sol.db;
+		sol = incumbent;
+		sol.db = db;
+	}
+	best = search.best;
+
+	if (!search.timeout) {
+		if (best == LONG_MAX) {
+			HEU_OUT(INFO) << "B&B: infeasible after " << m_nodes << " nodes" << std::endl;
+			return Infeasible;
+		}
+		sol.db = sol.total_cost;
+		HEU_OUT(INFO) << "B&B: optimal objective value " << sol.total_cost << " after " << m_nodes << " nodes" << std::endl;
+		return Optimal;
+	}
+
+	HEU_OUT(INFO) << "B&B: time limit reached after " << m_nodes << " nodes, objective value " << sol.total_cost << std::endl;
+	return best < LONG_MAX ? Feasible : Aborted;
+}
+
+// Instantiate all required branch-and-bound solver classes
+template class BranchAndBoundSolver<MLBP>;
+template class BranchAndBoundSolver<MLBPTW>;
@@ -0,0 +1,52 @@
+#ifndef __BRANCH_AND_BOUND_SOLVER_H__
+#define __BRANCH_AND_BOUND_SOLVER_H__
+
+#include <vector>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Native exact branch-and-bound for small MLBP and MLBPTW instances (no CPLEX).
+ * The levels are packed one after another, i.e. first all items into bins of level 1, then the
+ * used bins of level 1 into bins of level 2 and so on. Each node assigns the next element (decreasing size)
+ * to an opened bin of the current level or opens a new bin (depth-first, best fit first).
+ *
+ *  *) propagation -> residual capacities and, for MLBPTW, the intersection [max e, min l] of the time windows
+ *                    of the content of each bin (as in SolutionVerifier<MLBPTW>); an element only goes into
+ *                    a bin whose intersection stays non-empty, the used bins carry their windows to the next level
+ *  *) bound       -> cost of the opened bins + waiting penalty of the opened bins (only grows) + cost of the missing
+ *                    capacity of the current level and of all upper levels (cheapest cost per capacity, smallest size per capacity)
+ *  *) dominance   -> unused bins of identical capacity/cost/size are interchangeable (only the first is opened),
+ *                    identical consecutive elements go into bins opened in non-decreasing order,
+ *                    an element filling an opened bin exactly is put there (only MLBP)
+ *
+ *  Subtrees are distributed by work stealing: each thread owns a deque, splits its current node
+ *  while other threads are idle and steals the oldest (largest) subtree of another thread when its deque is empty.
+ *  The start solution (if feasible) and the fit decreasing heuristic provide the initial incumbent.
+ *  Status Optimal if the tree is exhausted (sol.db = sol.total_cost), Feasible on timeout.
+ */
+template<typename ProbT>
+class BranchAndBoundSolver : public SolverStatus
+{
+public:
+	BranchAndBoundSolver() : m_time_limit(0), m_threads(1), m_nodes(0) { }
+
+	void setTimeLimit(int time) { m_time_limit = time; }               // in seconds -> 0: no time limit
+	void setThreads(int number) { m_threads = std::max(1, number); }
+
+	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
+	long nodes() const { return m_nodes; }  // number of nodes from last run(...) call
+
+private:
+	int m_time_limit;
+	int m_threads;
+	long m_nodes;
+};
+
+#endif // __BRANCH_AND_BOUND_SOLVER_H__
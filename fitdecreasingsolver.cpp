@@ -0,0 +1,260 @@
+#include "fitdecreasingsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+#include "segmenttree.h"
+#include "openbins.h"
+
+#include <algorithm>
+#include <queue>
+#include <climits>
+#include <type_traits>
+
+// maximum number of bins with sufficient residual capacity checked for a compatible time window before a new bin is opened
+static const int MAX_CANDIDATES = 32;
+
+template<typename ProbT>
+typename FitDecreasingSolver<ProbT>::Status FitDecreasingSolver<ProbT>::run(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	bool found = pack(inst, false, sol);
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		// the sweep by earliest starting time keeps the penalty low, but may fragment the windows on tight instances
+		Solution<ProbT> cand(sol);
+		if (pack(inst, true, cand) && (!found || cand.total_cost < sol.total_cost)) {
+			sol = cand;
+			found = true;
+		}
+	}
+	if (!found) {
+		HEU_OUT(WARN) << "no feasible packing found" << std::endl;
+		return Aborted;
+	}
+
+	HEU_OUT(INFO) << (m_variant == FirstFit ? "FFD" : "BFD") << ": " << sol.total_bins << " bins, cost " << sol.total_cost << std::endl;
+	return Feasible;
+}
+
+template<typename ProbT>
+bool FitDecreasingSolver<ProbT>::pack(const Instance<ProbT>& inst, bool stabbing, Solution<ProbT>& sol) const
+{
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+	sol.total_bins = 0;
+	sol.total_cost = 0;
+
+	std::vector<Element> cur, next;
+	cur.reserve(inst.n[0]);
+	for (int i : inst.B[0]) {
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			cur.push_back(Element{i, inst.s[0][i], inst.e[i], inst.l[i]});
+		else
+			cur.push_back(Element{i, inst.s[0][i], INT_MIN, INT_MAX});
+	}
+
+	for (int k : inst.M) {
+		if (!packLevel(inst, k, stabbing, cur, sol.item_to_bins[k - 1], next)) {
+			HEU_OUT(DBG) << "no unused bin of level " << k << " left" << (stabbing ? " (stabbing order)" : "") << std::endl;
+			return false;
+		}
+		sol.total_bins += (int)next.size();
+		for (const Element& b : next)
+			sol.total_cost += inst.c[k][b.idx];
+		cur.swap(next);
+	}
+
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		// all items of a top-level bin start at the latest earliest starting time of its content
+		std::vector<int> start(inst.n[inst.m], 0);
+		for (const Element& b : cur)
+			start[b.idx] = b.e;
+		for (int i : inst.B[0]) {
+			int b = i;
+			for (int k = 0; k < inst.m; k++)
+				b = sol.item_to_bins[k][b];
+			sol.total_cost += inst.p * (start[b] - inst.e[i]);
+		}
+	}
+	return true;
+}
+
+template<typename ProbT>
+bool FitDecreasingSolver<ProbT>::packLevel(const Instance<ProbT>& inst, int k, bool stabbing, std::vector<Element>& elems, std::vector<int>& assign, std::vector<Element>& used) const
+{
+	// stabbing time of each element (minimum number of points hitting all windows), the elements sharing a
+	// stabbing time are packed consecutively, such that their bins stay compatible on the upper levels
+	std::vector<int> time(elems.size(), INT_MIN);
+	if (stabbing) {
+		std::sort(elems.begin(), elems.end(), [](const Element& a, const Element& b) {
+			return a.l != b.l ? a.l < b.l : a.idx < b.idx;
+		});
+		std::vector<std::pair<int, Element> > keyed;
+		keyed.reserve(elems.size());
+		int point = INT_MIN;
+		for (const Element& elem : elems) {
+			if (keyed.empty() || elem.e > point)
+				point = elem.l;
+			keyed.push_back(std::make_pair(point, elem));
+		}
+		std::sort(keyed.begin(), keyed.end(), [](const std::pair<int, Element>& a, const std::pair<int, Element>& b) {
+			if (a.first != b.first)
+				return a.first < b.first;
+			return a.second.size != b.second.size ? a.second.size > b.second.size : a.second.idx < b.second.idx;
+		});
+		for (int q = 0; q < (int)keyed.size(); q++) {
+			time[q] = keyed[q].first;
+			elems[q] = keyed[q].second;
+		}
+	} else if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		std::sort(elems.begin(), elems.end(), [](const Element& a, const Element& b) {
+			return a.e != b.e ? a.e < b.e : (a.size != b.size ? a.size > b.size : a.idx < b.idx);
+		});
+		for (int q = 0; q < (int)elems.size(); q++)
+			time[q] = elems[q].e;
+	} else
+		std::sort(elems.begin(), elems.end(), [](const Element& a, const Element& b) {
+			return a.size != b.size ? a.size > b.size : a.idx < b.idx;
+		});
+
+	// unused bins sorted by capacity, the bins an element fits into form a suffix
+	std::vector<int> bins(inst.B[k]);
+	std::sort(bins.begin(), bins.end(), [&](int a, int b) { return inst.w[k][a] < inst.w[k][b]; });
+	std::vector<int> cap(bins.size());
+	MinTree ratio((int)bins.size());
+	for (int q = 0; q < (int)bins.size(); q++) {
+		int j = bins[q];
+		cap[q] = inst.w[k][j];
+		ratio.set(q, (double)inst.c[k][j] / std::max(1, inst.w[k][j]));
+	}
+
+	// opened bins
+	std::vector<int> pos;       // position of the bin in bins
+	std::vector<int> residual;
+	std::vector<int> e, l;      // intersection of the time windows of the content
+	std::vector<char> active;
+
+	OpenBins open(m_variant == FirstFit ? OpenBins::FirstFit : OpenBins::BestFit);  // residual capacities of the active bins
+	std::vector<int> skipped;   // incompatible best-fit candidates, temporarily removed
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int> >, std::greater<std::pair<int, int> > > closing;
+
+	auto insert = [&](int b) { open.set(b, residual[b]); };
+	auto remove = [&](int b) { open.set(b, -1); };
+	auto compatible = [&](int b, const Element& elem) { return std::max(e[b], elem.e) <= std::min(l[b], elem.l); };
+
+	std::vector<int> owner(elems.size());
+	for (int q = 0; q < (int)elems.size(); q++) {
+		const Element& elem = elems[q];
+
+		// bins closed before the current (stabbing or earliest starting) time are retired
+		while (!closing.empty() && closing.top().first < time[q]) {
+			int b = closing.top().second;
+			if (active[b] && l[b] == closing.top().first) {
+				remove(b);
+				active[b] = 0;
+			}
+			closing.pop();
+		}
+
+		int b = -1;
+		if (m_variant == FirstFit) {
+			int from = 0;
+			for (int tries = 0; tries < MAX_CANDIDATES; tries++) {
+				int cand = open.firstFit(elem.size, from);
+				if (cand < 0)
+					break;
+				if (compatible(cand, elem)) {
+					b = cand;
+					break;
+				}
+				from = cand + 1;
+			}
+		} else {
+			for (int tries = 0; tries < MAX_CANDIDATES; tries++) {
+				int cand = open.bestFit(elem.size);
+				if (cand < 0)
+					break;
+				if (compatible(cand, elem)) {
+					b = cand;
+					break;
+				}
+				skipped.push_back(cand);
+				open.set(cand, -1);
+			}
+			for (int cand : skipped)
+				open.set(cand, residual[cand]);
+			skipped.clear();
+		}
+
+		if (b < 0) {
+			// open the unused bin with the lowest cost per capacity the element fits into
+			int from = (int)(std::lower_bound(cap.begin(), cap.end(), elem.size) - cap.begin());
+			int q_bin = ratio.argmin(from);
+			if (q_bin < 0)
+				return false;
+			ratio.remove(q_bin);
+
+			b = open.add(-1);
+			pos.push_back(q_bin);
+			residual.push_back(cap[q_bin]);
+			e.push_back(elem.e);
+			l.push_back(elem.l);
+			active.push_back(1);
+			closing.push(std::make_pair(elem.l, b));
+		} else {
+			remove(b);
+			e[b] = std::max(e[b], elem.e);
+			if (elem.l < l[b]) {
+				l[b] = elem.l;
+				closing.push(std::make_pair(l[b], b));
+			}
+		}
+		residual[b] -= elem.size;
+		insert(b);
+		owner[q] = b;
+	}
+
+	// downsizing: exchange each used bin for the cheapest unused bin which holds its content, largest content first
+	MinTree cost((int)bins.size());
+	std::vector<char> opened(bins.size(), 0);
+	for (int q : pos)
+		opened[q] = 1;
+	for (int q = 0; q < (int)bins.size(); q++)
+		if (!opened[q])
+			cost.set(q, inst.c[k][bins[q]]);
+
+	std::vector<int> order(pos.size());
+	for (int b = 0; b < (int)pos.size(); b++)
+		order[b] = b;
+	auto load = [&](int b) { return cap[pos[b]] - residual[b]; };
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return load(a) > load(b); });
+
+	int exchanged = 0;
+	for (int b : order) {
+		int from = (int)(std::lower_bound(cap.begin(), cap.end(), load(b)) - cap.begin());
+		int q = cost.argmin(from);
+		if (q < 0 || inst.c[k][bins[q]] >= inst.c[k][bins[pos[b]]])
+			continue;
+		cost.remove(q);
+		cost.set(pos[b], inst.c[k][bins[pos[b]]]);
+		residual[b] += cap[q] - cap[pos[b]];
+		pos[b] = q;
+		exchanged++;
+	}
+
+	for (int q = 0; q < (int)elems.size(); q++)
+		assign[elems[q].idx] = bins[pos[owner[q]]];
+
+	used.clear();
+	used.reserve(pos.size());
+	for (int b = 0; b < (int)pos.size(); b++) {
+		int j = bins[pos[b]];
+		used.push_back(Element{j, k < inst.m ? inst.s[k][j] : 0, e[b], l[b]});
+	}
+
+	HEU_OUT(DBG) << "level " << k << ": packed " << elems.size() << " elements into " << used.size() << " bins (" << exchanged << " downsized)" << std::endl;
+	return true;
+}
+
+
+template class FitDecreasingSolver<MLBP>;
+template class FitDecreasingSolver<MLBPTW>;
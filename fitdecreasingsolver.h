@@ -0,0 +1,64 @@
+#ifndef __FIT_DECREASING_SOLVER_H__
+#define __FIT_DECREASING_SOLVER_H__
+
+#include <vector>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Native First-Fit / Best-Fit Decreasing heuristic for MLBP and MLBPTW (no CPLEX needed).
+ * Packs level by level: the items of level 0 into bins of level 1, the used bins
+ * of level 1 into bins of level 2 and so on.
+ *
+ *  *) order       -> MLBP: decreasing size; MLBPTW: increasing earliest starting time (sweep) or grouped by
+ *                    stabbing time (minimum set of points hitting all windows), then decreasing size
+ *  *) first fit   -> first opened bin with enough residual capacity (see OpenBins)
+ *  *) best fit    -> opened bin with the smallest sufficient residual capacity (see OpenBins)
+ *  *) new bin     -> unused bin with the lowest cost per capacity among the bins the element fits into
+ *  *) downsizing  -> after a level is packed, each used bin is exchanged for the cheapest unused bin holding its content
+ *
+ *  For MLBPTW every bin keeps the intersection of the time windows of its content, an element is only
+ *  inserted if the intersection stays non-empty. Bins whose window closed before the current element are retired.
+ *  Both orders are tried for MLBPTW, the cheaper packing is returned.
+ *  Each level runs in O(n log n).
+ */
+template<typename ProbT>
+class FitDecreasingSolver : public SolverStatus
+{
+public:
+	enum Variant
+	{
+		FirstFit,
+		BestFit
+	};
+
+	FitDecreasingSolver(Variant variant = BestFit) : m_variant(variant) { }
+
+	void setVariant(Variant variant) { m_variant = variant; }
+
+	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
+	// element of a level: item/bin of index idx, its size and the (intersected) time window [e, l]
+	struct Element
+	{
+		int idx;
+		int size;
+		int e;
+		int l;
+	};
+
+private:
+	// packs all levels, returns false if a level runs out of bins
+	bool pack(const Instance<ProbT>& inst, bool stabbing, Solution<ProbT>& sol) const;
+
+	// packs elems into the bins of level k, writes item_to_bins[k-1] and returns the used bins of level k as the elements of level k+1
+	bool packLevel(const Instance<ProbT>& inst, int k, bool stabbing, std::vector<Element>& elems, std::vector<int>& assign, std::vector<Element>& used) const;
+
+	Variant m_variant;
+};
+
+#endif // __FIT_DECREASING_SOLVER_H__
@@ -0,0 +1,260 @@
+#include "groupinsertion.h"
+
+#include "instance.h"
+#include "solution.h"
+
+#include <algorithm>
+#include <climits>
+#include <type_traits>
+
+
+template<typename ProbT>
+void GroupInsertion<ProbT>::reset(const Instance<ProbT>& inst, const Solution<ProbT>* sol)
+{
+	const int m = inst.m;
+	residual.assign(m + 1, std::vector<int>());
+	used.assign(m + 1, std::vector<char>());
+	for (int k : inst.M) {
+		residual[k] = inst.w[k];
+		used[k].assign(inst.n[k], 0);
+		if (!sol)
+			continue;
+		// loads and used bins level by level
+		for (int x : inst.B[k - 1]) {
+			int b = sol->item_to_bins[k - 1][x];
+			if (b >= 0 && (k == 1 || used[k - 1][x])) {
+				residual[k][b] -= inst.s[k - 1][x];
+				used[k][b] = 1;
+			}
+		}
+	}
+
+	sorted.assign(m + 1, std::vector<int>());
+	cap.assign(m + 1, std::vector<int>());
+	position.assign(m + 1, std::vector<int>());
+	ratio.clear();
+	ratio.emplace_back(0);
+	for (int k : inst.M) {
+		sorted[k] = inst.B[k];
+		std::sort(sorted[k].begin(), sorted[k].end(), [&](int a, int b) { return inst.w[k][a] < inst.w[k][b]; });
+		cap[k].resize(inst.n[k]);
+		position[k].resize(inst.n[k]);
+		ratio.emplace_back(inst.n[k]);
+		for (int q = 0; q < inst.n[k]; q++) {
+			int j = sorted[k][q];
+			cap[k][q] = inst.w[k][j];
+			position[k][j] = q;
+			if (!used[k][j])
+				ratio[k].set(q, (double)inst.c[k][j] / std::max(1, inst.w[k][j]));
+		}
+	}
+
+	groups.clear();
+	group_of.assign(inst.n[m], -1);
+	active.clear();
+	room = MaxTree(inst.n[m]);
+	if (!sol)
+		return;
+
+	// subtrees and windows of the used top-level bins
+	auto top = [&](int k, int x) {
+		for (; k < m; k++)
+			x = sol->item_to_bins[k][x];
+		return x;
+	};
+	for (int j : inst.B[m])
+		if (used[m][j]) {
+			group_of[j] = (int)groups.size();
+			groups.push_back(Group{j, 0, INT_MAX, 0, std::vector<std::vector<int> >(m + 1)});
+			groups.back().bins[m].push_back(j);
+		}
+	for (int k = m - 1; k >= 1; k--)
+		for (int j : inst.B[k])
+			if (used[k][j])
+				groups[group_of[top(k, j)]].bins[k].push_back(j);
+	for (int i : inst.B[0])
+		if (sol->item_to_bins[0][i] >= 0)
+			add(inst, group_of[top(0, i)], i);
+	for (int g = 0; g < (int)groups.size(); g++)
+		open(g);
+}
+
+template<typename ProbT>
+long GroupInsertion<ProbT>::evaluate(const Instance<ProbT>& inst, int g, int size, Plan& plan) const
+{
+	const int m = inst.m;
+	const std::vector<std::vector<int> >* bins = g >= 0 ? &groups[g].bins : nullptr;
+	long cost = 0;
+	int need = size;
+	for (int k = 1; k <= m; k++) {
+		if (bins) {
+			int best = -1;
+			for (int j : (*bins)[k])
+				if (residual[k][j] >= need && (best < 0 || residual[k][j] < residual[k][best]))
+					best = j;
+			if (best >= 0) {
+				plan.bins[k] = best;
+				plan.fresh[k] = 0;
+				plan.depth = k;
+				return cost;
+			}
+			if (k == m)
+				return -1;
+		}
+		int from = (int)(std::lower_bound(cap[k].begin(), cap[k].end(), need) - cap[k].begin());
+		int q = -1;
+		if (bins && k < m) {
+			// prefer a bin which fits into the largest residual capacity of the next level of the group
+			int room = -1;
+			for (int j : (*bins)[k + 1])
+				room = std::max(room, residual[k + 1][j]);
+			if (room >= 0) {
+				int to = (int)(std::upper_bound(cap[k].begin(), cap[k].end(), room) - cap[k].begin());
+				if (from < to)
+					q = ratio[k].argmin(from, to);
+				if (q >= 0 && inst.s[k][sorted[k][q]] > room)
+					q = -1;
+			}
+		}
+		if (q < 0)
+			q = ratio[k].argmin(from);
+		if (q < 0)
+			return -1;
+		plan.bins[k] = sorted[k][q];
+		plan.fresh[k] = 1;
+		cost += inst.c[k][plan.bins[k]];
+		need = inst.s[k][plan.bins[k]];
+	}
+	plan.depth = m;
+	return cost;
+}
+
+template<typename ProbT>
+int GroupInsertion<ProbT>::insert(const Instance<ProbT>& inst, Solution<ProbT>& sol, int i, int candidates, int smallest)
+{
+	const int m = inst.m;
+	const int size = inst.s[0][i];
+	Plan plan(m), best_plan(m);
+	int best_group = -1, best_shrink = 0;
+	long best = evaluate(inst, -1, size, best_plan);
+
+	int evaluated = 0;
+	long tries = 0;
+	for (auto it = active.begin(); it != active.end() && evaluated < candidates && tries < 4L * candidates; tries++) {
+		int g = (it++)->second;
+		if (!compatible(inst, i, groups[g].u, groups[g].l))
+			continue;
+		long penalty = GroupInsertion<ProbT>::penalty(inst, i, groups[g].u, groups[g].count);
+		if (best >= 0 && penalty >= best)
+			continue;
+		long cost = evaluate(inst, g, size, plan);
+		if (cost < 0) {
+			// capacities only decrease, a group which can not take the smallest element is full
+			if (size <= smallest || evaluate(inst, g, smallest, plan) < 0)
+				close(g);
+			continue;
+		}
+		evaluated++;
+		// ties: the group whose window shrinks least, such that wide windows stay open for later items
+		int shrink = 0;
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			shrink = groups[g].l - std::min(groups[g].l, inst.l[i]);
+		if (best < 0 || cost + penalty < best || (cost + penalty == best && (best_group < 0 || shrink < best_shrink))) {
+			best = cost + penalty;
+			best_group = g;
+			best_shrink = shrink;
+			std::swap(best_plan, plan);
+		}
+	}
+
+	if (best < 0) {
+		// any open group with a bin of level 1 holding the item
+		tries = 0;
+		for (int g = room.findFirst(0, size); g >= 0 && tries < 4L * candidates; g = room.findFirst(g + 1, size), tries++)
+			if (compatible(inst, i, groups[g].u, groups[g].l)) {
+				best = evaluate(inst, g, size, best_plan);
+				best_group = g;
+				break;
+			}
+	}
+	if (best < 0)
+		return -1;
+
+	int g = best_group;
+	if (g < 0) {
+		g = (int)groups.size();
+		group_of[best_plan.bins[m]] = g;
+		groups.push_back(Group{best_plan.bins[m], 0, INT_MAX, 0, std::vector<std::vector<int> >(m + 1)});
+	} else
+		active.erase(std::make_pair(-groups[g].u, g));
+
+	// assign the item along the plan, the opened bins join the group
+	int child = i, load = size;
+	for (int k = 1; k <= best_plan.depth; k++) {
+		int j = best_plan.bins[k];
+		if (best_plan.fresh[k]) {
+			ratio[k].remove(position[k][j]);
+			used[k][j] = 1;
+			groups[g].bins[k].push_back(j);
+		}
+		sol.item_to_bins[k - 1][child] = j;
+		residual[k][j] -= load;
+		if (!best_plan.fresh[k])
+			break;
+		child = j;
+		load = inst.s[k][j];
+	}
+	add(inst, g, i);
+	open(g);
+	return g;
+}
+
+template<typename ProbT>
+void GroupInsertion<ProbT>::close(int g)
+{
+	active.erase(std::make_pair(-groups[g].u, g));
+	room.set(g, -1);
+}
+
+template<typename ProbT>
+void GroupInsertion<ProbT>::add(const Instance<ProbT>& inst, int g, int i)
+{
+	Group& group = groups[g];
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		group.u = group.count == 0 ? inst.e[i] : std::max(group.u, inst.e[i]);
+		group.l = std::min(group.l, inst.l[i]);
+	}
+	group.count++;
+}
+
+template<typename ProbT>
+void GroupInsertion<ProbT>::open(int g)
+{
+	int max_residual = -1;
+	for (int j : groups[g].bins[1])
+		max_residual = std::max(max_residual, residual[1][j]);
+	room.set(g, max_residual);
+	active.insert(std::make_pair(-groups[g].u, g));
+}
+
+template<typename ProbT>
+bool GroupInsertion<ProbT>::compatible(const Instance<ProbT>& inst, int i, int u, int l)
+{
+	if constexpr (std::is_same<ProbT, MLBPTW>::value)
+		return std::max(u, inst.e[i]) <= std::min(l, inst.l[i]);
+	else
+		return true;
+}
+
+template<typename ProbT>
+long GroupInsertion<ProbT>::penalty(const Instance<ProbT>& inst, int i, int u, long count)
+{
+	if constexpr (std::is_same<ProbT, MLBPTW>::value)
+		return inst.e[i] >= u ? (long)inst.p * (inst.e[i] - u) * count : (long)inst.p * (u - inst.e[i]);
+	else
+		return 0;
+}
+
+// Instantiate all required group insertion classes
+template struct GroupInsertion<MLBP>;
+template struct GroupInsertion<MLBPTW>;
@@ -0,0 +1,89 @@
+#ifndef __GROUP_INSERTION_H__
+#define __GROUP_INSERTION_H__
+
+#include <vector>
+#include <set>
+
+#include "problems.h"
+#include "segmenttree.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Insertion of an element into the packing tree of a top-level bin (a group) for the Multi-Level Bin Packing Problem
+ * (with time windows), shared by the time-window sweep, the stream packing and the incremental repair.
+ *
+ *  *) evaluate -> into the best fitting bin of the lowest level of the group; the missing bins below are opened by
+ *                 cost per capacity, preferring bins which fit into the largest residual capacity of the next level
+ *                 of the group; without a group a new chain of bins up to the top level is opened
+ *  *) insert   -> scans the open groups by latest start u for the smallest cost of the opened bins plus penalty
+ *                 (ties: the window shrinks least) against a new group; if neither fits, any open group with a bin
+ *                 of level 1 holding the item is taken; a group which can not take the smallest element is closed
+ *  *) penalty  -> (MLBPTW) waiting added by an item joining a group: either all items of the group or the item are delayed
+ *
+ *  The bins of each level are sorted by capacity, the unused bins an element fits into form a suffix.
+ */
+template<typename ProbT>
+struct GroupInsertion
+{
+	// bins used for inserting an element: bins[1...depth], fresh[k]: bins[k] has to be opened
+	struct Plan
+	{
+		Plan(int m) : bins(m + 1), fresh(m + 1), depth(0) { }
+
+		std::vector<int> bins;
+		std::vector<char> fresh;
+		int depth;
+	};
+
+	// top-level bin with its packing tree
+	struct Group
+	{
+		int top;
+		int u;       // common start time: max e of the items (MLBPTW)
+		int l;       // min l of the items (MLBPTW)
+		long count;  // number of items
+		std::vector<std::vector<int> > bins;  // bins[k]: used bins of level k
+	};
+
+	GroupInsertion() : room(0) { }
+
+	std::vector<std::vector<int> > sorted, cap, position;  // bins of each level sorted by capacity
+	std::vector<std::vector<int> > residual;               // residual capacity of all bins
+	std::vector<std::vector<char> > used;
+	std::vector<MinTree> ratio;                            // cost per capacity of the unused bins
+
+	std::vector<Group> groups;
+	std::vector<int> group_of;              // group of each top-level bin, -1: unused
+	std::set<std::pair<int, int> > active;  // (-u, group): open groups, latest start first
+	MaxTree room;                           // largest residual capacity of the bins of level 1 of each open group
+
+	// all bins unused, or (sol given) the used bins, residual capacities and open groups of sol
+	void reset(const Instance<ProbT>& inst, const Solution<ProbT>* sol = nullptr);
+
+	// plan for inserting an element of the given size into group g (g < 0: new chain); returns the cost of the opened
+	// bins or -1 if the element does not fit
+	long evaluate(const Instance<ProbT>& inst, int g, int size, Plan& plan) const;
+
+	// inserts item i, at most candidates open groups are evaluated among 4 * candidates tries; a group which can not
+	// take an element of size smallest is closed; returns the group of i or -1 if it does not fit
+	int insert(const Instance<ProbT>& inst, Solution<ProbT>& sol, int i, int candidates, int smallest);
+
+	// group g takes no further item
+	void close(int g);
+
+	// item i joins the window [u, l] and the count of group g
+	void add(const Instance<ProbT>& inst, int g, int i);
+
+	// group g takes items, its largest residual capacity of level 1 is updated
+	void open(int g);
+
+	// item i fits into the common window [u, l] of a group (always for MLBP)
+	static bool compatible(const Instance<ProbT>& inst, int i, int u, int l);
+
+	// waiting added by item i joining a group with common start time u and count items (0 for MLBP)
+	static long penalty(const Instance<ProbT>& inst, int i, int u, long count);
+};
+
+#endif // __GROUP_INSERTION_H__
@@ -0,0 +1,206 @@
+#include "incrementalsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "fitdecreasingsolver.h"
+#include "groupinsertion.h"
+#include "users.h"
+
+#include <climits>
+#include <set>
+#include <type_traits>
+
+
+namespace {
+
+// used bins of a partial solution with their residual capacities, the unused bins and the top-level bins with their subtrees
+template<typename ProbT>
+struct Repair
+{
+	const Instance<ProbT>& inst;
+	Solution<ProbT>& sol;
+	const int m;
+
+	GroupInsertion<ProbT> insertion;  // residual capacities, the unused bins of each level and the groups
+
+	Repair(const Instance<ProbT>& inst, Solution<ProbT>& sol) : inst(inst), sol(sol), m(inst.m)
+	{
+		insertion.reset(inst, &sol);
+	}
+
+	int top(int k, int x) const
+	{
+		for (; k < m; k++)
+			x = sol.item_to_bins[k][x];
+		return x;
+	}
+
+	// inserts item i with the smallest cost of the opened bins and waiting (all groups are candidates), returns its
+	// top-level bin or -1; groups which can not take an element of size smallest are no longer evaluated
+	int insert(int i, int smallest)
+	{
+		int g = insertion.insert(inst, sol, i, INT_MAX, smallest);
+		return g >= 0 ? insertion.groups[g].top : -1;
+	}
+
+	// cost of the used bins and waiting until the latest e of each top-level bin
+	void objective()
+	{
+		sol.total_cost = 0;
+		sol.total_bins = 0;
+		for (const typename GroupInsertion<ProbT>::Group& group : insertion.groups)
+			for (int k : inst.M)
+				for (int j : group.bins[k]) {
+					sol.total_cost += inst.c[k][j];
+					sol.total_bins++;
+				}
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			for (int i : inst.B[0])
+				sol.total_cost += inst.p * (insertion.groups[insertion.group_of[top(0, i)]].u - inst.e[i]);
+	}
+};
+
+} // namespace
+
+
+template<typename ProbT>
+typename IncrementalSolver<ProbT>::Status IncrementalSolver<ProbT>::run(const Instance<ProbT>& inst, const Solution<ProbT>& previous, const InstanceDelta<ProbT>& delta,
+                                                                       const std::vector<std::vector<int> >& map, Solution<ProbT>& sol)
+{
+	const int m = inst.m;
+	for (int k = 0; k < m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+
+	// items keep their chain of bins if all bins are still available
+	std::vector<char> reinsert(inst.n[0], 1);
+	std::set<int> affected;
+	for (int x = 0; x < (int)map[0].size(); x++) {
+		bool kept = map[0][x] >= 0;
+		int y = x, k = 0;
+		for (; k < m && previous.item_to_bins[k][y] >= 0 && map[k + 1][previous.item_to_bins[k][y]] >= 0; k++)
+			y = previous.item_to_bins[k][y];
+		if (k < m) {
+			if (previous.item_to_bins[k][y] < 0)
+				continue;
+			kept = false;
+		}
+		if (!kept) {
+			// the top-level bin loses an item
+			for (; k < m; k++)
+				y = previous.item_to_bins[k][y];
+			if (map[m][y] >= 0)
+				affected.insert(map[m][y]);
+			continue;
+		}
+		reinsert[map[0][x]] = 0;
+		for (int h = 0, z = x; h < m; h++) {
+			int b = previous.item_to_bins[h][z];
+			sol.item_to_bins[h][map[h][z]] = map[h + 1][b];
+			z = b;
+		}
+	}
+
+	// re-timing: items with a changed window leave a top-level bin whose common window becomes empty
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		std::vector<int> top(inst.B[0]), u(inst.n[m], INT_MIN), l(inst.n[m], INT_MAX);
+		for (int i : inst.B[0]) {
+			if (reinsert[i])
+				continue;
+			for (int k = 0; k < m; k++)
+				top[i] = sol.item_to_bins[k][top[i]];
+			u[top[i]] = std::max(u[top[i]], inst.e[i]);
+			l[top[i]] = std::min(l[top[i]], inst.l[i]);
+		}
+		std::vector<char> closed(inst.n[m], 0);
+		for (int i : delta.changed(inst, map))
+			if (!reinsert[i] && u[top[i]] > l[top[i]])
+				closed[top[i]] = 1;
+		for (int i : delta.changed(inst, map))
+			if (!reinsert[i] && closed[top[i]]) {
+				reinsert[i] = 1;
+				sol.item_to_bins[0][i] = -1;
+				affected.insert(top[i]);
+			}
+	}
+
+	// bins without content become unused
+	for (int k = 1; k < m; k++) {
+		std::vector<char> used(inst.n[k], 0);
+		for (int x : inst.B[k - 1])
+			if (sol.item_to_bins[k - 1][x] >= 0)
+				used[sol.item_to_bins[k - 1][x]] = 1;
+		for (int j : inst.B[k])
+			if (!used[j])
+				sol.item_to_bins[k][j] = -1;
+	}
+
+	// reinsert the remaining items, largest first
+	Repair<ProbT> repair(inst, sol);
+	std::vector<int> items;
+	for (int i : inst.B[0])
+		if (reinsert[i])
+			items.push_back(i);
+	std::stable_sort(items.begin(), items.end(), [&](int a, int b) { return inst.s[0][a] > inst.s[0][b]; });
+	for (int i : items) {
+		int top = repair.insert(i, inst.s[0][items.back()]);
+		if (top < 0) {
+			// the unused bins and compatible top-level bins do not suffice, pack the whole instance instead
+			HEU_OUT(WARN) << "incremental: no bins left for item " << i << ", packing from scratch" << std::endl;
+			Solution<ProbT> cand(inst);
+			if (FitDecreasingSolver<ProbT>(FitDecreasingSolver<ProbT>::BestFit).run(inst, cand) != Feasible)
+				return Aborted;
+			cand.db = sol.db;
+			sol = cand;
+			m_reinserted = inst.n[0];
+			m_affected = (int)std::set<int>(sol.item_to_bins[m - 1].begin(), sol.item_to_bins[m - 1].end()).size();
+			return sol.total_cost <= sol.db ? Optimal : Feasible;
+		}
+		affected.insert(top);
+	}
+	repair.objective();
+	m_reinserted = (int)items.size();
+	m_affected = (int)affected.size();
+	HEU_OUT(INFO) << "incremental: " << m_reinserted << " items reinserted into " << m_affected << " top-level bins, objective value " << sol.total_cost << std::endl;
+
+	if (!configure || affected.empty())
+		return sol.total_cost <= sol.db ? Optimal : Feasible;
+
+	// re-solve the subtrees of the affected top-level bins, unused bins are free
+	std::vector<std::vector<char> > free(m + 1);
+	for (int k = 0; k <= m; k++)
+		free[k].assign(inst.n[k], 0);
+	for (int k : inst.M)
+		for (int j : inst.B[k])
+			free[k][j] = k < m ? sol.item_to_bins[k][j] < 0 : repair.insertion.group_of[j] < 0;
+	for (int k = 0; k < m; k++)
+		for (int x : inst.B[k])
+			if (sol.item_to_bins[k][x] >= 0 && affected.count(repair.top(k, x)))
+				free[k][x] = 1;
+	for (int j : affected)
+		free[m][j] = 1;
+
+	Solution<ProbT> cand(sol);
+	Status status = Aborted;
+	try {
+		MIPSolver<ProbT> mip_solver;
+		configure(mip_solver);
+		mip_solver.setThreads(m_threads);
+		mip_solver.setTimeLimit(m_time_limit);
+		mip_solver.setFixing(&sol, free);
+		status = mip_solver.run(inst, cand);
+	} catch (const std::exception& exp) {
+		HEU_OUT(WARN) << "incremental: " << exp.what() << std::endl;
+	}
+	if ((status == Optimal || status == Feasible) && cand.total_cost < sol.total_cost && SolutionVerifier<ProbT>::verify(inst, cand)) {
+		int db = sol.db;
+		sol = cand;
+		sol.db = db;
+		HEU_OUT(INFO) << "incremental: re-solve improved the objective value to " << sol.total_cost << std::endl;
+	}
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+// Instantiate all required incremental solver classes
+template class IncrementalSolver<MLBP>;
+template class IncrementalSolver<MLBPTW>;
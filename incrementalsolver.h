@@ -0,0 +1,62 @@
+#ifndef __INCREMENTAL_SOLVER_H__
+#define __INCREMENTAL_SOLVER_H__
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+#include "mipsolver.h"
+#include "instancedelta.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Incremental re-optimisation of the Multi-Level Bin Packing Problem (with time windows) after a small change
+ * of the instance (see InstanceDelta). The solution of the previous instance is mapped to the new one and repaired locally:
+ *
+ *  *) mapping   -> an item keeps its chain of bins if all bins of the chain are still available, otherwise it is
+ *                  reinserted; bins without a remaining item become unused
+ *  *) re-timing -> (MLBPTW) items with a changed window are reinserted if the common window of their top-level bin
+ *                  becomes empty, the waiting of all top-level bins is recomputed
+ *  *) insertion -> reinserted and added items (largest first) go into the best fitting bin of the lowest level of a
+ *                  compatible top-level bin (missing bins below are opened by cost per capacity) or into a new chain
+ *  *) re-solve  -> optionally the subtrees of the affected top-level bins are freed and the MIP formulation is
+ *                  re-solved with everything else fixed (see MIPFormulation::fixSolution)
+ *
+ *  If an item does not fit into the remaining bins, the whole instance is packed by best-fit decreasing instead.
+ *  Status Feasible, Aborted if no packing is found.
+ */
+template<typename ProbT>
+class IncrementalSolver : public SolverStatus
+{
+public:
+	IncrementalSolver() : m_time_limit(10), m_threads(1), m_reinserted(0), m_affected(0) { }
+
+	// MIP formulation for re-solving the affected subtrees, must support MIPFormulation::fixSolution; not set: repair only
+	template<typename T>
+	void setFormulation() { configure = [](MIPSolver<ProbT>& solver) { solver.template setFormulation<T>(); }; }
+
+	void setTimeLimit(int time) { m_time_limit = time; }  // time limit of the re-solve in seconds
+	void setThreads(int number) { m_threads = number; }   // number of threads of the MIP solver
+
+	// repairs the solution previous of the instance before the delta into sol of the new instance inst,
+	// map from InstanceDelta::apply
+	Status run(const Instance<ProbT>& inst, const Solution<ProbT>& previous, const InstanceDelta<ProbT>& delta,
+	           const std::vector<std::vector<int> >& map, Solution<ProbT>& sol);
+
+	int reinserted() const { return m_reinserted; }  // number of reinserted items from last run(...) call
+	int affected() const { return m_affected; }      // number of affected top-level bins from last run(...) call
+
+private:
+	std::function<void(MIPSolver<ProbT>&)> configure;
+
+	int m_time_limit;
+	int m_threads;
+	int m_reinserted;
+	int m_affected;
+};
+
+#endif // __INCREMENTAL_SOLVER_H__
@@ -32,6 +32,13 @@ Instance<BP>::Instance(const std::string& input_file) : filename(input_file)
 	}
 }
 
+Instance<BP>::Instance(const std::vector<int>& sizes, int capacity) : n((int)sizes.size()), s(sizes), smax(capacity)
+{
+	I.reserve(n);
+	for (int i = 0; i < n; i++)
+		I.push_back(i);
+}
+
 int Instance<BP>::objective(const Solution<BP>& sol) const
 {
 	return sol.total_bins;
@@ -59,6 +66,55 @@ Instance<MLBP>::Instance(const std::string& input_file) : filename(input_file)
 	read_instance(file);
 }
 
+Instance<MLBP>::Instance(const Instance<MLBP>& inst, const std::vector<std::vector<int> >& subset) : filename(inst.filename), m(inst.m)
+{
+	n.assign(m+1, 0);
+	s.assign(m+1, std::vector<int>());
+	w.assign(m+1, std::vector<int>());
+	c.assign(m+1, std::vector<int>());
+	B.assign(m+1, std::vector<int>());
+	M.reserve(m);
+	for (int i = 0; i < m+1; i++) {
+		if (i != 0) M.push_back(i);
+		n[i] = (int)subset[i].size();
+		for (int j = 0; j < n[i]; j++) {
+			B[i].push_back(j);
+			s[i].push_back(inst.s[i][subset[i][j]]);
+			if (i != 0) {
+				w[i].push_back(inst.w[i][subset[i][j]]);
+				c[i].push_back(inst.c[i][subset[i][j]]);
+			}
+		}
+	}
+}
+
+Instance<MLBP>::Instance(const Instance<MLBP>& inst, int k, const std::vector<int>& items, const std::vector<int>& bins) : filename(inst.filename), m(1)
+{
+	n = {(int)items.size(), (int)bins.size()};
+	M = {1};
+	B.assign(2, std::vector<int>());
+	s.assign(2, std::vector<int>());
+	w.assign(2, std::vector<int>());
+	c.assign(2, std::vector<int>());
+	for (int x : items) {
+		B[0].push_back((int)s[0].size());
+		s[0].push_back(inst.s[k-1][x]);
+	}
+	for (int j : bins) {
+		B[1].push_back((int)s[1].size());
+		s[1].push_back(inst.s[k][j]);
+		w[1].push_back(inst.w[k][j]);
+		c[1].push_back(inst.c[k][j]);
+	}
+}
+
+int Instance<MLBP>::addItem(int size)
+{
+	B[0].push_back(n[0]);
+	s[0].push_back(size);
+	return n[0]++;
+}
+
 void Instance<MLBP>::read_instance(std::ifstream& file)
 {
 	// reading data from the file
@@ -236,6 +292,21 @@ Instance<MLBPTW>::Instance(const std::string& input_file) : Instance<MLBP>()
 		file >> l[i];
 }
 
+Instance<MLBPTW>::Instance(const Instance<MLBPTW>& inst, const std::vector<std::vector<int> >& subset) : Instance<MLBP>(inst, subset), p(inst.p)
+{
+	for (int i : subset[0]) {
+		e.push_back(inst.e[i]);
+		l.push_back(inst.l[i]);
+	}
+}
+
+int Instance<MLBPTW>::addItem(int size, int earliest, int latest)
+{
+	e.push_back(earliest);
+	l.push_back(latest);
+	return Instance<MLBP>::addItem(size);
+}
+
 int Instance<MLBPTW>::objective(const Solution<MLBPTW>& sol) const
 {
 	return sol.total_cost;
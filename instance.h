@@ -34,6 +34,9 @@ struct Instance<BP>
 
 	Instance(const std::string& input_file);
 
+	// instance of the given item sizes and bin size
+	Instance(const std::vector<int>& sizes, int capacity);
+
 	int objective(const Solution<BP>& sol) const;
 
 	std::string filename;
@@ -59,8 +62,17 @@ struct Instance<MLBP>
 
 	Instance(const std::string& input_file);
 
+	// sub-instance of the items/bins subset[k] of each level, index j of level k is subset[k][j] in inst
+	Instance(const Instance<MLBP>& inst, const std::vector<std::vector<int> >& subset);
+
+	// single-level instance (m = 1) of the elements items of level k - 1 and the bins of level k of inst
+	Instance(const Instance<MLBP>& inst, int k, const std::vector<int>& items, const std::vector<int>& bins);
+
 	int objective(const Solution<MLBP>& sol) const;
 
+	// appends an item of the given size, returns its index
+	int addItem(int size);
+
 	std::string filename;
 
 	int m;               // number of levels
@@ -147,8 +159,14 @@ struct Instance<MLBPTW> : public Instance<MLBP>
 
 	Instance(const std::string& input_file);
 
+	// sub-instance of the items/bins subset[k] of each level, index j of level k is subset[k][j] in inst
+	Instance(const Instance<MLBPTW>& inst, const std::vector<std::vector<int> >& subset);
+
 	int objective(const Solution<MLBPTW>& sol) const;
 
+	// appends an item of the given size and time window (streaming), returns its index
+	int addItem(int size, int earliest, int latest);
+
 	int p; // penalty factor
 	std::vector<int> e;  // earliest starting time of each item
 	std::vector<int> l;  // latest starting time of each item
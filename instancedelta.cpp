@@ -0,0 +1,103 @@
+#include "instancedelta.h"
+
+#include "instance.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+
+template<typename ProbT>
+void InstanceDelta<ProbT>::read(const std::string& filename)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+		throw std::runtime_error("Cannot open file!");
+
+	std::string line, type;
+	while (std::getline(file, line)) {
+		std::istringstream iss(line);
+		if (!(iss >> type) || type[0] == '#')
+			continue;
+		bool ok;
+		if (type == "add") {
+			Item item{0, 0, 0};
+			ok = (bool)(iss >> item.size);
+			if constexpr (std::is_same<ProbT, MLBPTW>::value)
+				ok = ok && (iss >> item.e >> item.l);
+			added.push_back(item);
+		} else if (type == "remove") {
+			int i;
+			ok = (bool)(iss >> i);
+			removed.push_back(i);
+		} else if (type == "window") {
+			Window window;
+			ok = (bool)(iss >> window.item >> window.e >> window.l);
+			windows.push_back(window);
+		} else if (type == "unavailable") {
+			int k, j;
+			ok = (bool)(iss >> k >> j);
+			unavailable.emplace_back(k, j);
+		} else
+			ok = false;
+		if (!ok)
+			throw std::runtime_error("Invalid delta: " + line);
+	}
+}
+
+template<typename ProbT>
+Instance<ProbT> InstanceDelta<ProbT>::apply(const Instance<ProbT>& inst, std::vector<std::vector<int> >& map) const
+{
+	std::vector<std::vector<char> > keep(inst.m + 1);
+	for (int k = 0; k <= inst.m; k++)
+		keep[k].assign(inst.n[k], 1);
+	for (int i : removed)
+		keep[0].at(i) = 0;
+	for (auto& bin : unavailable)
+		keep.at(bin.first).at(bin.second) = 0;
+
+	std::vector<std::vector<int> > subset(inst.m + 1);
+	map.assign(inst.m + 1, std::vector<int>());
+	for (int k = 0; k <= inst.m; k++) {
+		map[k].assign(inst.n[k], -1);
+		for (int x : inst.B[k])
+			if (keep[k][x]) {
+				map[k][x] = (int)subset[k].size();
+				subset[k].push_back(x);
+			}
+	}
+
+	Instance<ProbT> next(inst, subset);
+	for (const Item& item : added) {
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			next.addItem(item.size, item.e, item.l);
+		else
+			next.addItem(item.size);
+	}
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		for (const Window& window : windows)
+			if (map[0].at(window.item) >= 0) {
+				next.e[map[0][window.item]] = window.e;
+				next.l[map[0][window.item]] = window.l;
+			}
+	}
+	return next;
+}
+
+template<typename ProbT>
+std::vector<int> InstanceDelta<ProbT>::changed(const Instance<ProbT>& inst, const std::vector<std::vector<int> >& map) const
+{
+	std::vector<int> items;
+	for (const Window& window : windows)
+		if (map[0].at(window.item) >= 0)
+			items.push_back(map[0][window.item]);
+	// the added items follow the kept ones
+	for (int t = 0; t < (int)added.size(); t++)
+		items.push_back(inst.n[0] - (int)added.size() + t);
+	return items;
+}
+
+// Instantiate all required instance delta classes
+template struct InstanceDelta<MLBP>;
+template struct InstanceDelta<MLBPTW>;
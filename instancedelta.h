@@ -0,0 +1,55 @@
+#ifndef __INSTANCE_DELTA_H__
+#define __INSTANCE_DELTA_H__
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "problems.h"
+
+template<typename> struct Instance;
+
+/**
+ * Small change of a Multi-Level Bin Packing instance (with time windows) between two runs.
+ * Items and bins refer to the indices of the previous instance. A delta file has one change per line:
+ *
+ *  *) add s [e l]        -> new item of size s (time window [e, l] for MLBPTW)
+ *  *) remove i           -> item i is removed
+ *  *) window i e l       -> the time window of item i becomes [e, l] (only MLBPTW)
+ *  *) unavailable k j    -> bin j of level k can not be used any more
+ *
+ *  apply() builds the new instance: the remaining items/bins keep their order, added items are appended.
+ */
+template<typename ProbT>
+struct InstanceDelta
+{
+	struct Item
+	{
+		int size;
+		int e;
+		int l;
+	};
+
+	struct Window
+	{
+		int item;
+		int e;
+		int l;
+	};
+
+	std::vector<Item> added;
+	std::vector<int> removed;
+	std::vector<Window> windows;
+	std::vector<std::pair<int, int> > unavailable;  // (level, bin)
+
+	// reads a delta file, throws std::runtime_error on invalid lines
+	void read(const std::string& filename);
+
+	// new instance, map[k][x]: index of item/bin x of level k of inst in the new instance, -1 if removed
+	Instance<ProbT> apply(const Instance<ProbT>& inst, std::vector<std::vector<int> >& map) const;
+
+	// items of the new instance whose time window was changed or which were added
+	std::vector<int> changed(const Instance<ProbT>& inst, const std::vector<std::vector<int> >& map) const;
+};
+
+#endif // __INSTANCE_DELTA_H__
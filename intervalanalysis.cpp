@@ -0,0 +1,38 @@
+#include "intervalanalysis.h"
+
+#include "instance.h"
+
+#include <algorithm>
+#include <numeric>
+
+
+IntervalAnalysis::IntervalAnalysis(const Instance<MLBPTW>& inst) : m_e(inst.e), m_l(inst.l)
+{
+	std::vector<int> order(inst.B[0]);
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return m_l[a] != m_l[b] ? m_l[a] < m_l[b] : a < b; });
+
+	// an item starting after the l of the last independent item is independent
+	for (int i : order)
+		if (m_independent.empty() || m_e[i] > m_l[m_independent.back()])
+			m_independent.push_back(i);
+
+	// an item starting after all windows of the current component opens a new one
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return m_e[a] != m_e[b] ? m_e[a] < m_e[b] : a < b; });
+	int reach = 0;
+	for (int i : order) {
+		if (m_components.empty() || m_e[i] > reach) {
+			m_components.emplace_back();
+			reach = m_l[i];
+		}
+		m_components.back().push_back(i);
+		reach = std::max(reach, m_l[i]);
+	}
+}
+
+long IntervalAnalysis::binCost(const Instance<MLBPTW>& inst, int k) const
+{
+	std::vector<int> costs(inst.c[k].begin(), inst.c[k].begin() + inst.n[k]);
+	const int count = std::min((int)m_independent.size(), (int)costs.size());
+	std::partial_sort(costs.begin(), costs.begin() + count, costs.end());
+	return std::accumulate(costs.begin(), costs.begin() + count, 0L);
+}
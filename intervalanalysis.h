@@ -0,0 +1,43 @@
+#ifndef __INTERVAL_ANALYSIS_H__
+#define __INTERVAL_ANALYSIS_H__
+
+#include <vector>
+
+#include "problems.h"
+
+template<typename> struct Instance;
+
+/**
+ * Interval graph of the time windows [e_i, l_i] of the Multi-Level Bin Packing Problem with Time Windows:
+ * two items are adjacent if their windows overlap, only then they may share a top-level bin.
+ *
+ *  *) independent set  -> greedy sweep by increasing l (maximum for interval graphs), the items have pairwise
+ *                         disjoint windows and need distinct top-level bins, hence distinct bins on every level
+ *  *) separations      -> pairs of items with disjoint windows (forced into different top-level bins)
+ *  *) components       -> connected components by a sweep over increasing e, a new component starts when e exceeds
+ *                         the largest l so far; items of different components never share a top-level bin
+ */
+class IntervalAnalysis
+{
+public:
+	IntervalAnalysis(const Instance<MLBPTW>& inst);
+
+	// items with pairwise disjoint windows by increasing l
+	const std::vector<int>& independentSet() const { return m_independent; }
+
+	// items of each connected component by increasing e, the components by increasing time
+	const std::vector<std::vector<int> >& components() const { return m_components; }
+
+	// items a and b can never share a top-level bin
+	bool separated(int a, int b) const { return m_l[a] < m_e[b] || m_l[b] < m_e[a]; }
+
+	// lower bound on the cost of the bins of level k: the cheapest bins for the independent items
+	long binCost(const Instance<MLBPTW>& inst, int k) const;
+
+private:
+	std::vector<int> m_e, m_l;
+	std::vector<int> m_independent;
+	std::vector<std::vector<int> > m_components;
+};
+
+#endif // __INTERVAL_ANALYSIS_H__
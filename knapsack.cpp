@@ -0,0 +1,54 @@
+#include "knapsack.h"
+
+#include <algorithm>
+
+
+void KnapsackTable::solve(const std::vector<int>& size, const std::vector<double>& profit, int capacity)
+{
+	capacity = std::max(capacity, 0);
+	n = (int)size.size();
+	width = capacity + 1;
+	sizes = size;
+
+	best.assign(width, 0.0);
+	take.assign((size_t)n * width, 0);
+
+	for (int i = 0; i < n; i++) {
+		if (profit[i] <= 0.0 || size[i] > capacity)
+			continue;
+
+		char* row = &take[(size_t)i * width];
+		for (int c = capacity; c >= size[i]; c--) {
+			double val = best[c - size[i]] + profit[i];
+			if (val > best[c]) {
+				best[c] = val;
+				row[c] = 1;
+			}
+		}
+	}
+}
+
+void KnapsackTable::selection(int capacity, std::vector<int>& selected) const
+{
+	selected.clear();
+	int c = capacity;
+	for (int i = n - 1; i >= 0; i--) {
+		if (take[(size_t)i * width + c]) {
+			selected.push_back(i);
+			c -= sizes[i];
+		}
+	}
+	std::reverse(selected.begin(), selected.end());
+}
+
+double knapsack01(const std::vector<int>& size, const std::vector<double>& profit, int capacity, std::vector<int>& selected)
+{
+	selected.clear();
+	if (capacity < 0)
+		return 0.0;
+
+	KnapsackTable table;
+	table.solve(size, profit, capacity);
+	table.selection(capacity, selected);
+	return table.value(capacity);
+}
@@ -0,0 +1,44 @@
+#ifndef __KNAPSACK_H__
+#define __KNAPSACK_H__
+
+#include <vector>
+
+/**
+ * 0/1 knapsack solved by dynamic programming over the capacity.
+ * Runs in O(n * capacity) time and needs n * capacity bits to reconstruct the selection.
+ * A single run provides the optimal profit for all capacities up to the given one,
+ * hence bins of the same level can share one table.
+ */
+class KnapsackTable
+{
+public:
+	// size: size of each candidate (non-negative), profit: candidates with non-positive profit are never selected
+	void solve(const std::vector<int>& size, const std::vector<double>& profit, int capacity);
+
+	// maximum total profit for the given capacity (<= capacity passed to solve)
+	double value(int capacity) const { return best[capacity]; }
+
+	// indices of the selected candidates for the given capacity (<= capacity passed to solve)
+	void selection(int capacity, std::vector<int>& selected) const;
+
+private:
+	int n = 0;
+	int width = 1;
+	std::vector<double> best;  // best[c]: maximum profit with capacity c
+	std::vector<char> take;    // take[i*width + c]: candidate i improves best[c]
+	std::vector<int> sizes;
+};
+
+/**
+ * 0/1 knapsack for a single capacity.
+ *
+ * size:     size of each candidate (non-negative)
+ * profit:   profit of each candidate; candidates with non-positive profit are never selected
+ * capacity: knapsack capacity
+ * selected: indices (into size/profit) of the selected candidates
+ *
+ * Returns the maximum total profit.
+ */
+double knapsack01(const std::vector<int>& size, const std::vector<double>& profit, int capacity, std::vector<int>& selected);
+
+#endif // __KNAPSACK_H__
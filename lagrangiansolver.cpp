@@ -0,0 +1,243 @@
+#include "lagrangiansolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "knapsack.h"
+#include "users.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <climits>
+#include <limits>
+#include <cmath>
+
+static const double EPS = 1e-6;
+
+
+double LagrangianSolver::elapsed() const
+{
+	std::chrono::duration<double> d = std::chrono::steady_clock::now() - m_start;
+	return d.count();
+}
+
+LagrangianSolver::Status LagrangianSolver::run(const Instance<MLBP>& inst, Solution<MLBP>& sol)
+{
+	m_start = std::chrono::steady_clock::now();
+	m_iterations = 0;
+
+	// initial multipliers: size times the cheapest cost per capacity of the next level
+	std::vector<double> rate(inst.m + 1, 0.0);
+	for (int k : inst.M) {
+		rate[k] = std::numeric_limits<double>::max();
+		for (int j : inst.B[k])
+			if (inst.w[k][j] > 0)
+				rate[k] = std::min(rate[k], (double)inst.c[k][j] / inst.w[k][j]);
+	}
+	pi.assign(inst.n[0], 0.0);
+	for (int i : inst.B[0])
+		pi[i] = inst.s[0][i] * rate[1];
+	lambda.assign(inst.m + 1, std::vector<double>());
+	for (int k = 0; k <= inst.m; k++) {
+		lambda[k].assign(inst.n[k], 0.0);
+		if (k > 0 && k < inst.m)
+			for (int j : inst.B[k])
+				lambda[k][j] = inst.s[k][j] * rate[k + 1];
+	}
+
+	open.assign(inst.m + 1, std::vector<char>());
+	gain.assign(inst.m + 1, std::vector<double>());
+	inserted.assign(inst.m, std::vector<int>());
+	for (int k = 0; k <= inst.m; k++) {
+		open[k].assign(inst.n[k], 0);
+		gain[k].assign(inst.n[k], 0.0);
+		if (k < inst.m)
+			inserted[k].assign(inst.n[k], 0);
+	}
+
+	int ub = INT_MAX;
+	Solution<MLBP> cand(sol);
+	if (heuristic(inst, cand)) {
+		sol = cand;
+		ub = sol.total_cost;
+	}
+	LR_OUT(DBG) << "initial upper bound: " << ub << std::endl;
+
+	double best_lb = 0.0;
+	double theta = 2.0;
+	int no_improvement = 0;
+	std::vector<double> contribution(inst.m + 1, 0.0);
+
+	for (m_iterations = 0; m_iterations < m_iteration_limit; m_iterations++) {
+		if (m_time_limit != 0 && elapsed() >= m_time_limit)
+			break;
+
+		// solve the levels in parallel
+		std::atomic<int> next(1);
+		auto worker = [&]() {
+			for (int k = next++; k <= inst.m; k = next++)
+				contribution[k] = solveLevel(inst, k);
+		};
+		std::vector<std::thread> threads;
+		for (int t = 1; t < std::min(m_threads, inst.m); t++)
+			threads.emplace_back(worker);
+		worker();
+		for (auto& thread : threads)
+			thread.join();
+
+		double lb = std::accumulate(pi.begin(), pi.end(), 0.0) + std::accumulate(contribution.begin(), contribution.end(), 0.0);
+		if (lb > best_lb + EPS) {
+			best_lb = lb;
+			no_improvement = 0;
+		} else if (++no_improvement >= 20) {
+			theta /= 2.0;
+			no_improvement = 0;
+		}
+		LR_OUT(TRACE) << "iteration " << m_iterations << ": L=" << lb << ", best=" << best_lb << ", theta=" << theta << std::endl;
+
+		if (ub != INT_MAX && std::ceil(best_lb - EPS) >= ub)
+			break;  // proven optimal
+		if (theta < 1e-4)
+			break;
+
+		// subgradients
+		double norm = 0.0;
+		for (int i : inst.B[0])
+			norm += std::pow(1 - inserted[0][i], 2);
+		for (int k = 1; k < inst.m; k++)
+			for (int j : inst.B[k])
+				norm += std::pow(open[k][j] - inserted[k][j], 2);
+		if (norm < EPS)
+			break;  // relaxed solution is feasible, hence optimal
+
+		if (m_iterations % 10 == 9 && heuristic(inst, cand) && cand.total_cost < ub) {
+			sol = cand;
+			ub = sol.total_cost;
+			LR_OUT(DBG) << "iteration " << m_iterations << ": new upper bound " << ub << std::endl;
+		}
+
+		double target = (ub != INT_MAX) ? ub : std::max(1.0, 1.05 * std::fabs(lb));
+		double step = theta * (target - lb) / norm;
+		for (int i : inst.B[0])
+			pi[i] += step * (1 - inserted[0][i]);
+		for (int k = 1; k < inst.m; k++)
+			for (int j : inst.B[k])
+				lambda[k][j] += step * (open[k][j] - inserted[k][j]);
+	}
+
+	if (heuristic(inst, cand) && cand.total_cost < ub) {
+		sol = cand;
+		ub = sol.total_cost;
+	}
+	LR_OUT(DBG) << "finished after " << m_iterations << " iterations, bounds: [" << best_lb << ", " << ub << "]" << std::endl;
+
+	if (ub == INT_MAX)
+		return Aborted;
+
+	sol.db = (int)std::ceil(best_lb - EPS);
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+double LagrangianSolver::solveLevel(const Instance<MLBP>& inst, int k)
+{
+	const std::vector<double>& profit = (k == 1) ? pi : lambda[k - 1];
+
+	int capacity = 0;
+	for (int j : inst.B[k])
+		capacity = std::max(capacity, inst.w[k][j]);
+
+	KnapsackTable table;
+	table.solve(inst.s[k - 1], profit, capacity);
+
+	std::fill(inserted[k - 1].begin(), inserted[k - 1].end(), 0);
+	double sum = 0.0;
+	std::vector<int> selected;
+	for (int j : inst.B[k]) {
+		gain[k][j] = inst.c[k][j] + lambda[k][j] - table.value(inst.w[k][j]);
+		open[k][j] = gain[k][j] < 0.0;
+		if (!open[k][j])
+			continue;
+
+		sum += gain[k][j];
+		table.selection(inst.w[k][j], selected);
+		for (int i : selected)
+			inserted[k - 1][i]++;
+	}
+	return sum;
+}
+
+bool LagrangianSolver::heuristic(const Instance<MLBP>& inst, Solution<MLBP>& sol) const
+{
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+	sol.total_bins = 0;
+	sol.total_cost = 0;
+
+	std::vector<int> cur(inst.B[0]);  // items/bins of the current level which must be packed
+	std::vector<int> selected;
+	std::vector<int> size;
+	std::vector<double> profit;
+	std::vector<int> pos;
+
+	for (int k = 1; k <= inst.m; k++) {
+		const std::vector<double>& weight = (k == 1) ? pi : lambda[k - 1];
+
+		// bins opened in the relaxation first (by reduced cost), then by Lagrangian cost per capacity
+		std::vector<int> order;
+		for (int j : inst.B[k])
+			if (inst.w[k][j] > 0)
+				order.push_back(j);
+		std::sort(order.begin(), order.end(), [&](int a, int b) {
+			if (open[k][a] != open[k][b])
+				return open[k][a] > open[k][b];
+			if (open[k][a])
+				return gain[k][a] < gain[k][b];
+			return (inst.c[k][a] + lambda[k][a]) / inst.w[k][a] < (inst.c[k][b] + lambda[k][b]) / inst.w[k][b];
+		});
+
+		// maximize the filled size, the multipliers only break ties
+		double bonus = 1.0;
+		for (int i : cur)
+			bonus += std::max(0.0, weight[i]);
+
+		std::vector<char> packed(cur.size(), 0);
+		int remaining = (int)cur.size();
+		std::vector<int> next;
+		for (int j : order) {
+			if (remaining == 0)
+				break;
+
+			size.clear();
+			profit.clear();
+			pos.clear();
+			for (int q = 0; q < (int)cur.size(); q++) {
+				if (!packed[q] && inst.s[k - 1][cur[q]] <= inst.w[k][j]) {
+					pos.push_back(q);
+					size.push_back(inst.s[k - 1][cur[q]]);
+					profit.push_back(inst.s[k - 1][cur[q]] + std::max(0.0, weight[cur[q]]) / bonus + EPS);
+				}
+			}
+			if (pos.empty())
+				continue;
+
+			knapsack01(size, profit, inst.w[k][j], selected);
+			if (selected.empty())
+				continue;
+
+			for (int q : selected) {
+				packed[pos[q]] = 1;
+				sol.item_to_bins[k - 1][cur[pos[q]]] = j;
+			}
+			remaining -= (int)selected.size();
+			next.push_back(j);
+			sol.total_bins++;
+			sol.total_cost += inst.c[k][j];
+		}
+
+		if (remaining > 0)
+			return false;
+		cur.swap(next);
+	}
+	return true;
+}
@@ -0,0 +1,64 @@
+#ifndef __LAGRANGIAN_SOLVER_H__
+#define __LAGRANGIAN_SOLVER_H__
+
+#include <vector>
+#include <chrono>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Lagrangian relaxation for the Multi-Level Bin Packing Problem.
+ * Relaxes the rows
+ *
+ *  *) sum_j x_{0ij} = 1        -> each item is inserted into exactly one bin (multipliers pi_i)
+ *  *) sum_j x_{kij} = y_{ki}   -> each used bin is inserted into exactly one bin (multipliers lambda_{ki})
+ *
+ *  The relaxation decomposes into one knapsack per bin: bin j of level k is opened
+ *  if c_{kj} + lambda_{kj} is smaller than the best profit of the elements of level
+ *  k-1 fitting into w_{kj}. All bins of a level share a single DP table, the levels
+ *  are solved in parallel. The multipliers are updated by subgradient steps (Polyak step size).
+ *
+ *  The Lagrangian heuristic packs level by level, preferring the bins opened in the relaxation.
+ *  It does not need CPLEX.
+ */
+class LagrangianSolver : public SolverStatus
+{
+public:
+	LagrangianSolver() : m_time_limit(0), m_threads(1), m_iteration_limit(1000), m_iterations(0) { }
+
+	void setTimeLimit(int time) { m_time_limit = time; }
+	void setThreads(int number) { m_threads = number; }
+	void setIterationLimit(int number) { m_iteration_limit = number; }
+
+	Status run(const Instance<MLBP>& inst, Solution<MLBP>& sol);
+
+	int iterations() const { return m_iterations; }  // number of subgradient iterations from last run(...) call
+
+private:
+	// solves the relaxation of level k for the current multipliers, returns its contribution to the Lagrangian bound
+	double solveLevel(const Instance<MLBP>& inst, int k);
+
+	// primal heuristic guided by the multipliers, returns false if it fails to pack all items
+	bool heuristic(const Instance<MLBP>& inst, Solution<MLBP>& sol) const;
+
+	double elapsed() const;
+
+	std::vector<double> pi;                    // multipliers of the items
+	std::vector<std::vector<double> > lambda;  // multipliers of the bins of level 1...m-1, index 0 and m are zero
+
+	std::vector<std::vector<char> > open;      // open[k][j]: bin j of level k is used in the relaxation
+	std::vector<std::vector<double> > gain;    // gain[k][j]: reduced cost of bin j of level k
+	std::vector<std::vector<int> > inserted;   // inserted[k][i]: number of bins of level k+1 item/bin i of level k is inserted into
+
+	int m_time_limit;       // in seconds -> 0: no time limit
+	int m_threads;          // number of threads used for the subproblems
+	int m_iteration_limit;  // maximum number of subgradient iterations
+	int m_iterations;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // __LAGRANGIAN_SOLVER_H__
@@ -0,0 +1,186 @@
+#include "lnssolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "users.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <chrono>
+#include <type_traits>
+
+
+template<typename ProbT>
+typename LNSSolver<ProbT>::Status LNSSolver<ProbT>::run(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto elapsed = [&start]() {
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+		return d.count();
+	};
+
+	std::vector<Neighbourhood> types{Subtree, WorstFill};
+	if constexpr (std::is_same<ProbT, MLBPTW>::value)
+		types.insert(types.begin() + 1, TimeSlice);
+
+	std::mt19937 rng(m_seed);
+	int next_type = 0;
+	m_rounds = 0;
+
+	while (elapsed() < m_time_limit) {
+		int sub_time = std::max(1, std::min(m_sub_time_limit, (int)(m_time_limit - elapsed())));
+
+		// neighbourhoods are drawn sequentially, such that the search is reproducible for a given seed
+		std::vector<std::vector<std::vector<char> > > free(m_threads);
+		for (int t = 0; t < m_threads; t++)
+			free[t] = neighbourhood(inst, sol, types[next_type++ % types.size()], rng);
+
+		std::vector<Solution<ProbT> > cand(m_threads, sol);
+		std::vector<Status> status(m_threads, Aborted);
+		auto worker = [&](int t) {
+			try {
+				MIPSolver<ProbT> sub;
+				configure(sub);
+				sub.setThreads(1);
+				sub.setTimeLimit(sub_time);
+				sub.setFixing(&sol, free[t]);
+				status[t] = sub.run(inst, cand[t]);
+			} catch (const std::exception&) {
+				status[t] = Aborted;
+			}
+		};
+		std::vector<std::thread> threads;
+		for (int t = 1; t < m_threads; t++)
+			threads.emplace_back(worker, t);
+		worker(0);
+		for (auto& thread : threads)
+			thread.join();
+
+		// keep the best improving sub-MIP solution
+		int best = -1;
+		for (int t = 0; t < m_threads; t++) {
+			if (status[t] != Optimal && status[t] != Feasible)
+				continue;
+			if (cand[t].total_cost >= (best < 0 ? sol.total_cost : cand[best].total_cost))
+				continue;
+			if (SolutionVerifier<ProbT>::verify(inst, cand[t]))
+				best = t;
+		}
+		if (best >= 0) {
+			int db = sol.db;
+			sol = cand[best];
+			sol.db = db;
+			MIP_OUT(DBG) << "LNS round " << m_rounds << ": improved objective value to " << sol.total_cost << std::endl;
+		}
+		m_rounds++;
+
+		if (sol.total_cost <= sol.db)
+			break;
+	}
+
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+template<typename ProbT>
+std::vector<std::vector<char> > LNSSolver<ProbT>::neighbourhood(const Instance<ProbT>& inst, const Solution<ProbT>& sol, Neighbourhood type, std::mt19937& rng) const
+{
+	const int target = std::max(1, (int)(m_fraction * inst.n[0]));
+
+	// used bins and their loads
+	std::vector<std::vector<int> > load(inst.m + 1);
+	for (int k = 1; k <= inst.m; k++)
+		load[k].assign(inst.n[k], 0);
+	for (int k = 0; k < inst.m; k++)
+		for (int i : inst.B[k])
+			if (sol.item_to_bins[k][i] >= 0)
+				load[k + 1][sol.item_to_bins[k][i]] += inst.s[k][i];
+
+	// top-level bin of each item
+	std::vector<int> top(inst.B[0]);
+	for (int k = 0; k < inst.m; k++)
+		for (int& b : top)
+			b = sol.item_to_bins[k][b];
+
+	// roots of freed subtrees
+	std::vector<std::vector<char> > free(inst.m + 1);
+	for (int k = 0; k <= inst.m; k++)
+		free[k].assign(inst.n[k], 0);
+
+	int freed = 0;
+	if (type == Subtree) {
+		std::vector<int> tops;
+		for (int j : inst.B[inst.m])
+			if (load[inst.m][j] > 0)
+				tops.push_back(j);
+		std::shuffle(tops.begin(), tops.end(), rng);
+		std::vector<int> items_per_top(inst.n[inst.m], 0);
+		for (int i : inst.B[0])
+			items_per_top[top[i]]++;
+		for (int j : tops) {
+			if (freed >= target)
+				break;
+			free[inst.m][j] = 1;
+			freed += items_per_top[j];
+		}
+	} else if (type == WorstFill) {
+		std::vector<std::pair<double, std::pair<int, int> > > fill;
+		for (int k : inst.M)
+			for (int j : inst.B[k])
+				if (load[k][j] > 0)
+					fill.push_back({(double)load[k][j] / inst.w[k][j], {k, j}});
+		std::sort(fill.begin(), fill.end());
+
+		// number of items below each bin
+		std::vector<std::vector<int> > items(inst.m + 1);
+		items[0].assign(inst.n[0], 1);
+		for (int k = 1; k <= inst.m; k++) {
+			items[k].assign(inst.n[k], 0);
+			for (int i : inst.B[k - 1])
+				if (sol.item_to_bins[k - 1][i] >= 0)
+					items[k][sol.item_to_bins[k - 1][i]] += items[k - 1][i];
+		}
+		for (const auto& f : fill) {
+			if (freed >= target)
+				break;
+			free[f.second.first][f.second.second] = 1;
+			freed += items[f.second.first][f.second.second];
+		}
+	}
+
+	// free the content of the roots
+	for (int k = inst.m - 1; k >= 0; k--)
+		for (int i : inst.B[k])
+			if (sol.item_to_bins[k][i] >= 0 && free[k + 1][sol.item_to_bins[k][i]])
+				free[k][i] = 1;
+
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		if (type == TimeSlice) {
+			// consecutive items ordered by earliest starting time together with the bins containing them
+			std::vector<int> order(inst.B[0]);
+			std::sort(order.begin(), order.end(), [&inst](int a, int b) { return inst.e[a] < inst.e[b]; });
+			int first = std::uniform_int_distribution<int>(0, std::max(0, inst.n[0] - target))(rng);
+			for (int q = first; q < std::min(inst.n[0], first + target); q++) {
+				int b = order[q];
+				free[0][b] = 1;
+				for (int k = 0; k < inst.m; k++) {
+					b = sol.item_to_bins[k][b];
+					free[k + 1][b] = 1;
+				}
+			}
+		}
+	}
+
+	// unused bins are always free
+	for (int k = 1; k <= inst.m; k++)
+		for (int j : inst.B[k])
+			if (load[k][j] == 0)
+				free[k][j] = 1;
+
+	return free;
+}
+
+// Instantiate all required LNS solver classes
+template class LNSSolver<MLBP>;
+template class LNSSolver<MLBPTW>;
@@ -0,0 +1,73 @@
+#ifndef __LNS_SOLVER_H__
+#define __LNS_SOLVER_H__
+
+#include <vector>
+#include <functional>
+#include <random>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+#include "mipsolver.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * MIP-based Large Neighbourhood Search which polishes a feasible solution.
+ * In each round, every thread frees a neighbourhood of the incumbent and
+ * re-solves the MIP formulation with all other x_{kij} fixed to the incumbent
+ * (see MIPFormulation::fixSolution) under a short time limit.
+ * The best of the parallel sub-MIP solutions becomes the new incumbent.
+ *
+ * Neighbourhoods (unused bins are always free):
+ *  *) subtree   -> items and bins below randomly chosen top-level bins
+ *  *) timeslice -> items whose earliest starting time lies in a random time interval and their bins (only MLBPTW)
+ *  *) worstfill -> bins with the worst fill ratio and their content
+ */
+template<typename ProbT>
+class LNSSolver : public SolverStatus
+{
+public:
+	enum Neighbourhood
+	{
+		Subtree,
+		TimeSlice,
+		WorstFill
+	};
+
+	LNSSolver() : m_time_limit(60), m_sub_time_limit(5), m_threads(1), m_seed(0), m_fraction(0.2), m_rounds(0)
+	{
+		configure = [](MIPSolver<ProbT>&) { };
+	}
+
+	// MIP formulation used for the sub-MIPs, must support MIPFormulation::fixSolution
+	template<typename T>
+	void setFormulation() { configure = [](MIPSolver<ProbT>& solver) { solver.template setFormulation<T>(); }; }
+
+	void setTimeLimit(int time) { m_time_limit = time; }          // total time limit in seconds
+	void setSubTimeLimit(int time) { m_sub_time_limit = time; }   // time limit of each sub-MIP in seconds
+	void setThreads(int number) { m_threads = std::max(1, number); }  // number of sub-MIPs solved in parallel
+	void setSeed(unsigned int seed) { m_seed = seed; }
+	void setFraction(double fraction) { m_fraction = fraction; }  // approximate fraction of freed items
+
+	// improves the feasible solution sol
+	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
+	int rounds() const { return m_rounds; }  // number of rounds from last run(...) call
+
+private:
+	// free[k][i]: item/bin i of level k may be repacked
+	std::vector<std::vector<char> > neighbourhood(const Instance<ProbT>& inst, const Solution<ProbT>& sol, Neighbourhood type, std::mt19937& rng) const;
+
+	std::function<void(MIPSolver<ProbT>&)> configure;
+
+	int m_time_limit;
+	int m_sub_time_limit;
+	int m_threads;
+	unsigned int m_seed;
+	double m_fraction;
+	int m_rounds;
+};
+
+#endif // __LNS_SOLVER_H__
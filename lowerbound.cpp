@@ -0,0 +1,149 @@
+#include "lowerbound.h"
+
+#include "instance.h"
+#include "intervalanalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <type_traits>
+
+
+template<typename ProbT>
+int LowerBound<ProbT>::compute(const Instance<ProbT>& inst)
+{
+	return (int)std::ceil(binCost(inst) - 1e-6) + (int)penalty(inst);
+}
+
+template<typename ProbT>
+double LowerBound<ProbT>::cover(std::vector<Group>& bins, double need)
+{
+	std::sort(bins.begin(), bins.end(), [](const Group& a, const Group& b) { return a.cost * b.capacity < b.cost * a.capacity; });
+	double cost = 0;
+	for (const Group& bin : bins) {
+		if (need <= 0)
+			break;
+		if (bin.capacity <= 0)
+			continue;
+		double part = std::min((double)bin.count, need / bin.capacity);
+		cost += part * bin.cost;
+		need -= part * bin.capacity;
+	}
+	return cost;
+}
+
+template<typename ProbT>
+std::vector<typename LowerBound<ProbT>::Group> LowerBound<ProbT>::groups(const Instance<ProbT>& inst, int k, bool by_size)
+{
+	std::map<std::pair<int, int>, long> count;
+	for (int j : inst.B[k])
+		count[std::make_pair(inst.w[k][j], by_size ? inst.s[k][j] : inst.c[k][j])]++;
+	std::vector<Group> bins;
+	for (auto& group : count)
+		bins.push_back(Group{(double)group.first.first, (double)group.first.second, group.second});
+	return bins;
+}
+
+template<typename ProbT>
+double LowerBound<ProbT>::binCost(const Instance<ProbT>& inst)
+{
+	if (inst.n[0] == 0)
+		return 0;
+
+	// items grouped by size
+	std::map<int, long> items;
+	double size = 0;
+	for (int i : inst.B[0]) {
+		items[inst.s[0][i]]++;
+		size += inst.s[0][i];
+	}
+	const int largest = items.rbegin()->first;
+
+	// continuous relaxation, each level needs at least one bin (on level 1 one holding the largest item),
+	// with time windows one bin for each item of an independent set
+	std::vector<long> separated(inst.m + 1, 0);
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		IntervalAnalysis windows(inst);
+		for (int k : inst.M)
+			separated[k] = windows.binCost(inst, k);
+	}
+	double total = 0, level1 = 0;
+	for (int k : inst.M) {
+		double cheapest = INFINITY;
+		for (int j : inst.B[k])
+			if (k > 1 || inst.w[k][j] >= largest)
+				cheapest = std::min(cheapest, (double)inst.c[k][j]);
+		std::vector<Group> bins = groups(inst, k, false);
+		double cost = std::max({cover(bins, size), std::isinf(cheapest) ? 0.0 : cheapest, (double)separated[k]});
+		if (k == 1)
+			level1 = cost;
+		total += cost;
+
+		// smallest total size of the bins holding the elements
+		if (k < inst.m) {
+			bins = groups(inst, k, true);
+			size = cover(bins, size);
+		}
+	}
+
+	// level 1 with dual feasible functions f: sum f(s_i) <= f(w_j) for the items of bin j
+	const std::vector<Group> level1_bins = groups(inst, 1, false);
+	int W = 0;
+	for (const Group& bin : level1_bins)
+		W = std::max(W, (int)bin.capacity);
+	if (W == 0)
+		return total;
+	std::vector<Group> bins;
+	auto transformed = [&](auto f) {
+		double need = 0;
+		for (auto& item : items)
+			need += item.second * f(item.first);
+		bins = level1_bins;
+		for (Group& bin : bins)
+			bin.capacity = f((long)bin.capacity);
+		return cover(bins, need);
+	};
+	double best = level1;
+	for (long t = 2; t <= 20; t++)
+		best = std::max(best, transformed([&](long x) { return (double)(t * x / W); }));
+
+	std::vector<int> thresholds;
+	for (auto& item : items)
+		if (item.first > 0 && 2L * item.first <= W)
+			thresholds.push_back(item.first);
+	const int step = std::max(1, (int)thresholds.size() / 32);
+	for (int q = 0; q < (int)thresholds.size(); q += step) {
+		const long eps = thresholds[q];
+		best = std::max(best, transformed([&](long x) { return x > W - eps ? (double)W : x >= eps ? (double)x : 0.0; }));
+	}
+
+	return total - level1 + best;
+}
+
+template<typename ProbT>
+long LowerBound<ProbT>::penalty(const Instance<ProbT>& inst)
+{
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		std::map<int, long> count;
+		for (int i : inst.B[0])
+			count[inst.e[i]]++;
+		const int D = (int)count.size(), T = inst.n[inst.m];
+		if (D <= T || T == 0)
+			return 0;
+
+		// waiting of all items of a value until the next larger value, the D - T smallest ones
+		std::vector<long> wait;
+		for (auto it = count.begin(); std::next(it) != count.end(); ++it)
+			wait.push_back(it->second * (long)(std::next(it)->first - it->first));
+		std::nth_element(wait.begin(), wait.begin() + (D - T), wait.end());
+		long sum = 0;
+		for (int q = 0; q < D - T; q++)
+			sum += wait[q];
+		return (long)inst.p * sum;
+	}
+	return 0;
+}
+
+// Instantiate all required lower bound classes
+template class LowerBound<MLBP>;
+template class LowerBound<MLBPTW>;
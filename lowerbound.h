@@ -0,0 +1,53 @@
+#ifndef __LOWER_BOUND_H__
+#define __LOWER_BOUND_H__
+
+#include <vector>
+
+#include "problems.h"
+
+template<typename> struct Instance;
+
+/**
+ * Fast combinatorial lower bounds for the Multi-Level Bin Packing Problem (with time windows),
+ * computed directly from the instance without any model (O(n log n) per bound).
+ *
+ *  *) continuous -> level by level: the used bins of level k hold a total size of at least S_k (S_1: size of all items);
+ *                   the cheapest bins covering S_k (fractional, by cost per capacity) bound the cost of level k and the
+ *                   smallest total size of bins covering S_k (fractional, by size per capacity) bounds S_{k+1}
+ *  *) windows    -> only MLBPTW: the items of an independent set of the time windows need distinct bins on every level
+ *  *) dff        -> level 1 with item sizes and capacities transformed by superadditive dual feasible functions
+ *                   (rounding floor(t s / W) and the large-item function of Fekete and Schepers)
+ *  *) penalty    -> only MLBPTW: at most n_m top-level bins exist, hence at least D - n_m of the D distinct values
+ *                   of e are no latest start of a top-level bin and their items wait at least until the next larger value
+ *
+ *  The bound of MLBPTW is the bound of the bins plus the penalty bound.
+ */
+template<typename ProbT>
+class LowerBound
+{
+public:
+	static int compute(const Instance<ProbT>& inst);
+
+	// lower bound on the cost of the bins
+	static double binCost(const Instance<ProbT>& inst);
+
+	// lower bound on the waiting penalty (0 for MLBP)
+	static long penalty(const Instance<ProbT>& inst);
+
+private:
+	// bins of equal capacity and cost (or size)
+	struct Group
+	{
+		double capacity;
+		double cost;
+		long count;
+	};
+
+	// cheapest fractional cover of need by the bins
+	static double cover(std::vector<Group>& bins, double need);
+
+	// bins of level k grouped by capacity and cost (size instead of cost if by_size)
+	static std::vector<Group> groups(const Instance<ProbT>& inst, int k, bool by_size);
+};
+
+#endif // __LOWER_BOUND_H__
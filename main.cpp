@@ -2,6 +2,10 @@
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
+#include <sstream>
+#include <map>
+#include <set>
+#include <type_traits>
 
 #include "lib/util.h"
 #include "lib/log.h"
@@ -13,15 +17,75 @@
 #include "instance.h"           // contains for each problem an instance class that contains all information related to a specific instance of a problem
 #include "solution.h"           // contains for each problem a solution class that represents a solution to a specific instance
 #include "solution_verifier.h"  // verifies if a solution is feasible with respect to a given instance object
+#include "lowerbound.h"         // fast combinatorial lower bounds for the multi-level bin packing problem (with time windows)
 
 // MIP stuff
 #include "mipsolver.h"        // generic mip solver, uses CPLEX to solve mips
 #include "bpformulation.h"    // mip formulation for the bin packing problem
 #include "mlbpformulation.h"  // mip formulation for the multi-level bin packing problem
 #include "mlbpnfformulation.h"// mip network flow formulation for the multi-level bin packing problem
+#include "mlbparcflowformulation.h"// mip arc-flow formulation for the multi-level bin packing problem with a single level
 #include "mlbptwformulation.h"// mip formulation for the multi-level bin packing problem with time windows
 #include "mlbptwnfformulation.h"// mip network flow formulation for the multi-level bin packing problem with time windows
 
+// decomposition approaches
+#include "mlbptwcgsolver.h"   // column generation over top-level patterns for the multi-level bin packing problem with time windows
+#include "bendersformulation.h" // benders decomposition into top-level master and lower-level packing subproblems
+#include "lagrangiansolver.h"   // lagrangian relaxation with subgradient optimization for the multi-level bin packing problem
+#include "lnssolver.h"          // MIP-based large neighbourhood search to improve feasible solutions
+#include "mlbptwdecompositionsolver.h" // connected components of the time windows solved in parallel
+#include "mlbptwrollinghorizonsolver.h" // rolling-horizon MIP over windows of the earliest starting times
+#include "quantisedsolver.h"    // coarse instance with rounded sizes and capacities for huge, fine-grained sizes
+#include "incrementalsolver.h"  // local repair and re-solve of a solution after a change of the instance
+
+// heuristics
+#include "fitdecreasingsolver.h" // level-wise first-fit/best-fit decreasing for the multi-level bin packing problem (with time windows)
+#include "mlbptwsweepsolver.h"   // time-window sweep over top-level groups for the multi-level bin packing problem with time windows
+#include "mlbptwstreamsolver.h"  // online packing of arriving items for the multi-level bin packing problem with time windows
+#include "vnssolver.h"           // variable neighbourhood search to improve feasible solutions without CPLEX
+#include "memeticsolver.h"       // parallel memetic algorithm (island model) for the multi-level bin packing problem (with time windows)
+#include "minbinslacksolver.h"   // bin-oriented minimum bin slack heuristic for the multi-level bin packing problem
+#include "mlbphierarchicalsolver.h" // level-by-level bin packing with the bin packing solvers for the multi-level bin packing problem
+
+// exact approaches without CPLEX
+#include "branchandboundsolver.h" // level-wise branch-and-bound with work stealing for small instances (with time windows)
+#include "bpsolver.h"             // bin completion with reductions and nogoods for the bin packing problem
+
+
+// algorithms for the coarse instance of the quantisation and the components of the decomposition
+const std::set<std::string> sub_algorithms = {"MIP", "FFD", "BFD", "SWEEP", "BB"};
+
+// solves a coarse instance or a component by one of the sub_algorithms (SWEEP only for MLBPTW)
+template<typename ProbT>
+SolverStatus::Status solveWith(const std::string& alg, const Instance<ProbT>& inst, Solution<ProbT>& sol, int time, int threads)
+{
+	if (alg == "FFD" || alg == "BFD")
+		return FitDecreasingSolver<ProbT>(alg == "FFD" ? FitDecreasingSolver<ProbT>::FirstFit : FitDecreasingSolver<ProbT>::BestFit).run(inst, sol);
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		if (alg == "SWEEP")
+			return MLBPTWSweepSolver().run(inst, sol);
+	}
+	if (alg == "BB") {
+		BranchAndBoundSolver<ProbT> bb_solver;
+		bb_solver.setTimeLimit(time);
+		bb_solver.setThreads(threads);
+		return bb_solver.run(inst, sol);
+	}
+	if (alg != "MIP")
+		throw std::invalid_argument("algorithm " + alg + " can not solve a coarse instance or component");
+
+	MIPSolver<ProbT> mip_solver;
+	mip_solver.setTimeLimit(time);
+	mip_solver.setThreads(threads);
+	if constexpr (std::is_same<ProbT, MLBPTW>::value)
+		mip_solver.template setFormulation<MLBPTWFormulation>();
+	else if (inst.m == 1)
+		mip_solver.template setFormulation<MLBPArcFlowFormulation>();  // single level -> arc-flow formulation over the coarse capacities
+	else
+		mip_solver.template setFormulation<MLBPFormulation>();
+	return mip_solver.run(inst, sol);
+}
+
 
 int main(int argc, char* argv[])
 {
@@ -35,8 +99,22 @@ int main(int argc, char* argv[])
 	try {
 		arg_parser.add<std::string>("ifile", "Input file", "inst/bp/bp1.inst");
 		arg_parser.add<std::string>("prob", "Problem: Bin Packing (BP), Multi-Level Bin Packing (MLBP), Multi-Level Bin Packing - Network Flow formulation (MLBPNF), Multi-Level Bin Packing with Time Windows (MLBPTW), Multi-Level Bin Packing with Time Windows - Network Flow formulation (MLBPTWNF)", "BP", {"BP", "MLBP", "MLBPNF", "MLBPTW", "MLBPTWNF"});
+		arg_parser.add<std::string>("alg", "Algorithm: MIP formulation (MIP), Column Generation (CG, only MLBPTW), Benders Decomposition (BD, MLBP and MLBPTW), Lagrangian Relaxation (LR, only MLBP), Level-wise Relax-and-Fix of the MIP formulation (RF), First-Fit Decreasing (FFD, MLBP and MLBPTW), Best-Fit Decreasing (BFD, MLBP and MLBPTW), Time-Window Sweep (SWEEP, only MLBPTW), Memetic Algorithm with one island per thread (MA, MLBP and MLBPTW), Minimum Bin Slack (MBS, only MLBP), Native Branch-and-Bound (BB, bin completion for BP, small MLBP and MLBPTW instances), Hierarchical Level-by-level bin packing (HL, only MLBP)", "MIP", {"MIP", "CG", "BD", "LR", "RF", "FFD", "BFD", "SWEEP", "MA", "MBS", "BB", "HL"});
 		arg_parser.add<int>("ttime", "total time limit", 0, 0, std::numeric_limits<int>::max());
 		arg_parser.add<int>("threads", "Number of used threads", 1, 0, 100);
+		arg_parser.add<int>("vns", "Time limit of the variable neighbourhood search which improves a feasible solution of MLBP and MLBPTW without CPLEX; 0 -> no search", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<int>("lns", "Time limit of the large neighbourhood search which improves a feasible solution of MLBP and MLBPTW; 0 -> no search", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<int>("horizon", "Window length H of the rolling-horizon MIP for MLBPTW, each window solves the items with e in [t, t + H]; only with --alg MIP, not with --grid, --geometric or --decomp; 0 -> no rolling horizon", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<int>("step", "Advance of the rolling horizon after each window, at most H; 0 -> H / 2", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<std::string>("stream", "Online packing of MLBPTW into the bins of the instance, items \"s e l\" arrive in order of e from a file, stdin (-) or the items of the instance (replay); empty -> offline", "");
+		arg_parser.add<int>("lookahead", "Number of buffered items of the online packing before a decision; 0 -> immediate decisions", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<std::string>("delta", "Change of the MLBP/MLBPTW instance (add/remove items, new time windows, unavailable bins) after which the solution is repaired locally; with --resolve > 0 the affected subtrees are re-solved by the MIP; empty -> no re-planning", "");
+		arg_parser.add<int>("resolve", "Time limit of the MIP re-solve of the top-level bins affected by --delta; 0 -> local repair only", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<int>("batch", "Elements per batch of HL, the levels are pipelined in own threads; 0 -> one batch per level", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<int>("levelmip", "Solve the levels of HL by CPLEX (BPFormulation, MLBPArcFlowFormulation) instead of the native solvers (BPSolver, BB)", 0, 0, 1);
+		arg_parser.add<int>("grid", "Round the sizes of MLBP/MLBPTW up and the capacities down to multiples of q and solve the coarse instance by FFD, BFD, SWEEP, BB or MIP; 0, 1 -> no rounding", 0, 0, std::numeric_limits<int>::max());
+		arg_parser.add<int>("geometric", "Round the sizes of MLBP/MLBPTW up to geometric classes growing by eps percent and solve the coarse instance by FFD, BFD, SWEEP, BB or MIP, not together with --grid; 0 -> no rounding", 0, 0, 1000);
+		arg_parser.add<int>("decomp", "Split MLBPTW into the connected components of the time windows, solved in parallel by FFD, BFD, SWEEP, BB or MIP; 0 -> no decomposition", 0, 0, 1);
 
 		if (arg_parser.isHelpSet()) {
 			arg_parser.help(std::cout);
@@ -44,6 +122,35 @@ int main(int argc, char* argv[])
 		}
 
 		arg_parser.parse();
+
+		// reject algorithms which are not available for the problem instead of falling back to the MIP
+		const std::map<std::string, std::set<std::string> > algorithms = {
+			{"BP", {"MIP", "BB"}},
+			{"MLBP", {"MIP", "BD", "LR", "RF", "FFD", "BFD", "MA", "MBS", "BB", "HL"}},
+			{"MLBPNF", {"MIP", "RF"}},
+			{"MLBPTW", {"MIP", "CG", "BD", "RF", "FFD", "BFD", "SWEEP", "MA", "BB"}},
+			{"MLBPTWNF", {"MIP", "RF"}}
+		};
+		const std::string prob = arg_parser.get<std::string>("prob"), alg = arg_parser.get<std::string>("alg");
+		auto available = algorithms.find(prob);
+		if (available != algorithms.end() && !available->second.count(alg))
+			throw std::invalid_argument("algorithm " + alg + " is not available for " + prob);
+
+		// the quantisation and the decomposition only run the sub_algorithms
+		const bool quantised = (prob == "MLBP" || prob == "MLBPTW") && (arg_parser.get<int>("grid") > 1 || arg_parser.get<int>("geometric") > 0);
+		const bool decomposed = prob == "MLBPTW" && arg_parser.get<int>("decomp");
+		if (arg_parser.get<int>("grid") > 1 && arg_parser.get<int>("geometric") > 0)
+			throw std::invalid_argument("grid and geometric rounding can not be combined");
+		if ((quantised || decomposed) && !sub_algorithms.count(alg))
+			throw std::invalid_argument("algorithm " + alg + " can not solve the " + (quantised ? "quantised instance" : "time-window components"));
+
+		// the rolling horizon solves each window by the MIP formulation
+		if (prob == "MLBPTW" && arg_parser.get<int>("horizon") > 0) {
+			if (alg != "MIP")
+				throw std::invalid_argument("the rolling horizon solves its windows by the MIP, algorithm " + alg + " is not available");
+			if (quantised || decomposed)
+				throw std::invalid_argument("the rolling horizon can not be combined with " + std::string(quantised ? "grid or geometric rounding" : "the decomposition"));
+		}
 	} catch (const std::exception& exp) {
 		std::cerr << "ERROR: " << exp.what() << std::endl;
 		return EXIT_FAILURE;
@@ -64,16 +171,29 @@ int main(int argc, char* argv[])
 
 		Solution<BP> sol(inst);  // create empty BP solution
 
-		// setup MIP solver
-		MIPSolver<BP> mip_solver;
-		mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
-		mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should be always one for our experiments
+		SolverStatus::Status status;
+		if (arg_parser.get<std::string>("alg") == "BB") {
+			// setup bin completion solver
+			BPSolver bp_solver;
+			bp_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
 
-		mip_solver.setFormulation<BPFormulation>();  // set MIP formulation
+			/**************************************************************/
+			status = bp_solver.run(inst, sol);  /** run bin completion ****/
+			/**************************************************************/
 
-		/**************************************************************/
-		auto status = mip_solver.run(inst, sol);  /** run MIP solver **/
-		/**************************************************************/
+			SOUT() << "branch-and-bound nodes:\t" << bp_solver.nodes() << std::endl;
+		} else {
+			// setup MIP solver
+			MIPSolver<BP> mip_solver;
+			mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+			mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should be always one for our experiments
+
+			mip_solver.setFormulation<BPFormulation>();  // set MIP formulation
+
+			/**************************************************************/
+			status = mip_solver.run(inst, sol);  /** run MIP solver *******/
+			/**************************************************************/
+		}
 
 		if (status == MIPSolver<BP>::Feasible || status == MIPSolver<BP>::Optimal) {
 			SOUT() << std::endl;
@@ -104,18 +224,141 @@ int main(int argc, char* argv[])
 
 		Solution<MLBP> sol(inst);  // create empty MLBP solution
 
-		// setup MIP solver
-		MIPSolver<MLBP> mip_solver;
-		mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
-		mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should always be one for our experiments
+		// fast combinatorial lower bound, the heuristics stop as soon as they reach it
+		const int lower_bound = LowerBound<MLBP>::compute(inst);
+		sol.db = lower_bound;
+		SOUT() << "combinatorial lower bound:\t" << lower_bound << std::endl;
+
+		SolverStatus::Status status;
+		if (arg_parser.get<int>("grid") > 1 || arg_parser.get<int>("geometric") > 0) {
+			// setup size quantisation, the coarse instance is solved by FFD, BFD, BB or MIP (see solveWith)
+			QuantisedSolver<MLBP> q_solver(arg_parser.get<int>("grid") > 1 ? QuantisedSolver<MLBP>::Grid : QuantisedSolver<MLBP>::Geometric,
+			                               arg_parser.get<int>("grid") > 1 ? arg_parser.get<int>("grid") : 1.0 + arg_parser.get<int>("geometric") / 100.0);
+			const std::string alg = arg_parser.get<std::string>("alg");
+			const int time = arg_parser.get<int>("ttime"), threads = arg_parser.get<int>("threads");
+			q_solver.setSolver([alg, time, threads](const Instance<MLBP>& coarse, Solution<MLBP>& coarse_sol) {
+				return solveWith(alg, coarse, coarse_sol, time, threads);
+			});
+
+			/**************************************************************/
+			status = q_solver.run(inst, sol);  /** run quantisation *******/
+			/**************************************************************/
+
+			SOUT() << "quantised sizes:\t" << q_solver.classes() << std::endl;
+			SOUT() << "inflation of the sizes:\t" << q_solver.inflation() << std::endl;
+			SOUT() << "proven gap:\t" << q_solver.gap() * 100.0 << "%" << std::endl;
+		} else if (arg_parser.get<std::string>("alg") == "LR") {
+			// setup lagrangian relaxation
+			LagrangianSolver lr_solver;
+			lr_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+			lr_solver.setThreads(arg_parser.get<int>("threads"));  // number of threads used for the subproblems
+
+			/**************************************************************/
+			status = lr_solver.run(inst, sol);  /** run LR solver *********/
+			/**************************************************************/
+
+			SOUT() << "subgradient iterations:\t" << lr_solver.iterations() << std::endl;
+		} else if (arg_parser.get<std::string>("alg") == "FFD" || arg_parser.get<std::string>("alg") == "BFD") {
+			// setup level-wise fit decreasing heuristic
+			FitDecreasingSolver<MLBP> fd_solver(arg_parser.get<std::string>("alg") == "FFD" ? FitDecreasingSolver<MLBP>::FirstFit : FitDecreasingSolver<MLBP>::BestFit);
+
+			/**************************************************************/
+			status = fd_solver.run(inst, sol);  /** run heuristic *********/
+			/**************************************************************/
+		} else if (arg_parser.get<std::string>("alg") == "MA") {
+			// setup memetic algorithm
+			MemeticSolver<MLBP> ma_solver;
+			if (arg_parser.get<int>("ttime") > 0)
+				ma_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; default 60 seconds
+			ma_solver.setThreads(arg_parser.get<int>("threads"));  // number of islands, one per thread
+
+			/**************************************************************/
+			status = ma_solver.run(inst, sol);  /** run memetic algorithm */
+			/**************************************************************/
+
+			SOUT() << "generations:\t" << ma_solver.generations() << std::endl;
+		} else if (arg_parser.get<std::string>("alg") == "MBS") {
+			// setup minimum bin slack heuristic
+			MinBinSlackSolver mbs_solver;
+
+			/**************************************************************/
+			status = mbs_solver.run(inst, sol);  /** run heuristic ********/
+			/**************************************************************/
+		} else if (arg_parser.get<std::string>("alg") == "BB") {
+			// setup branch-and-bound
+			BranchAndBoundSolver<MLBP> bb_solver;
+			bb_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+			bb_solver.setThreads(arg_parser.get<int>("threads"));  // number of threads sharing the search tree
+
+			/**************************************************************/
+			status = bb_solver.run(inst, sol);  /** run branch-and-bound **/
+			/**************************************************************/
+
+			SOUT() << "branch-and-bound nodes:\t" << bb_solver.nodes() << std::endl;
+		} else if (arg_parser.get<std::string>("alg") == "HL") {
+			// setup level-by-level bin packing
+			MLBPHierarchicalSolver hl_solver(arg_parser.get<int>("levelmip") ? MLBPHierarchicalSolver::MIP : MLBPHierarchicalSolver::Native);
+			if (arg_parser.get<int>("ttime") > 0)
+				hl_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; default 10 seconds
+			hl_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads by CPLEX
+			hl_solver.setBatch(arg_parser.get<int>("batch"));
+
+			/**************************************************************/
+			status = hl_solver.run(inst, sol);  /** run heuristic *********/
+			/**************************************************************/
+
+			SOUT() << "batches:\t" << hl_solver.batches() << std::endl;
+		} else {
+			// setup MIP solver
+			MIPSolver<MLBP> mip_solver;
+			mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+			mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should always be one for our experiments
+			mip_solver.setRelaxAndFix(arg_parser.get<std::string>("alg") == "RF");  // fix the MIP level by level
+
+			if (arg_parser.get<std::string>("alg") == "BD")
+				mip_solver.setFormulation<BendersFormulation<MLBP> >(arg_parser.get<int>("threads"));  // set Benders master, subproblems are solved in parallel
+			else if (inst.m == 1 && arg_parser.get<std::string>("alg") == "MIP")
+				mip_solver.setFormulation<MLBPArcFlowFormulation>();  // single level -> variable-sized bin packing, arc-flow formulation
+			else
+				mip_solver.setFormulation<MLBPFormulation>();  // set MIP formulation
+
+			/**************************************************************/
+			status = mip_solver.run(inst, sol);  /** run MIP solver *******/
+			/**************************************************************/
+		}
 
-		mip_solver.setFormulation<MLBPFormulation>();  // set MIP formulation
+		// stop early if the solution meets the combinatorial lower bound
+		sol.db = std::max(sol.db, lower_bound);
+		if (status == SolverStatus::Feasible && inst.objective(sol) <= sol.db)
+			status = SolverStatus::Optimal;
 
-		/**************************************************************/
-		auto status = mip_solver.run(inst, sol);  /** run MIP solver **/
-		/**************************************************************/
+		if (status == SolverStatus::Feasible && arg_parser.get<int>("vns") > 0) {
+			// improve the solution by local search on the bin assignment
+			VNSSolver<MLBP> vns_solver;
+			vns_solver.setTimeLimit(arg_parser.get<int>("vns"));
 
-		if (status == MIPSolver<MLBP>::Feasible || status == MIPSolver<MLBP>::Optimal) {
+			/**************************************************************/
+			status = vns_solver.run(inst, sol);  /** run VNS **************/
+			/**************************************************************/
+
+			SOUT() << "VNS iterations:\t" << vns_solver.iterations() << std::endl;
+		}
+
+		if (status == SolverStatus::Feasible && arg_parser.get<int>("lns") > 0) {
+			// polish the solution by solving sub-MIPs in parallel
+			LNSSolver<MLBP> lns_solver;
+			lns_solver.setTimeLimit(arg_parser.get<int>("lns"));
+			lns_solver.setThreads(arg_parser.get<int>("threads"));  // number of sub-MIPs solved in parallel
+			lns_solver.setFormulation<MLBPFormulation>();
+
+			/**************************************************************/
+			status = lns_solver.run(inst, sol);  /** run LNS **************/
+			/**************************************************************/
+
+			SOUT() << "LNS rounds:\t" << lns_solver.rounds() << std::endl;
+		}
+
+		if (status == SolverStatus::Feasible || status == SolverStatus::Optimal) {
 			SOUT() << std::endl;
 			SOUT() << "# best solution:" << sol << std::endl;
 			SOUT() << "best objective value:\t" << inst.objective(sol) << std::endl;
@@ -131,6 +374,50 @@ int main(int argc, char* argv[])
 				std::cerr << *it << std::endl;
 			return EXIT_FAILURE;
 		}
+
+		if (!arg_parser.get<std::string>("delta").empty()) {
+			// re-plan after a change of the instance, starting from the solution above
+			InstanceDelta<MLBP> delta;
+			try {
+				delta.read(arg_parser.get<std::string>("delta"));
+			} catch (const std::exception& exp) {
+				std::cerr << "ERROR: " << exp.what() << std::endl;
+				return EXIT_FAILURE;
+			}
+			std::vector<std::vector<int> > map;
+			Instance<MLBP> next_inst = delta.apply(inst, map);  // map of the items and bins to the new instance
+			Solution<MLBP> next_sol(next_inst);
+			next_sol.db = LowerBound<MLBP>::compute(next_inst);
+
+			IncrementalSolver<MLBP> inc_solver;
+			if (arg_parser.get<int>("resolve") > 0) {
+				inc_solver.setFormulation<MLBPFormulation>();  // re-solve the affected subtrees
+				inc_solver.setTimeLimit(arg_parser.get<int>("resolve"));
+			}
+			inc_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads by CPLEX
+
+			int delta_ticket = LuTze::start();
+			/**************************************************************/
+			status = inc_solver.run(next_inst, sol, delta, map, next_sol);  /** run re-planning **/
+			/**************************************************************/
+
+			SOUT() << std::endl;
+			SOUT() << "re-planning time:\t" << LuTze::end(delta_ticket) << std::endl;
+			SOUT() << "reinserted items:\t" << inc_solver.reinserted() << std::endl;
+			SOUT() << "affected top-level bins:\t" << inc_solver.affected() << std::endl;
+			if (status == SolverStatus::Feasible || status == SolverStatus::Optimal) {
+				SOUT() << "# re-planned solution:" << next_sol << std::endl;
+				SOUT() << "re-planned objective value:\t" << next_inst.objective(next_sol) << std::endl;
+				SOUT() << "re-planned dual bound value:\t" << next_sol.db << std::endl;
+			}
+
+			if (!SolutionVerifier<MLBP>::verify(next_inst, next_sol, &msg)) {
+				std::cerr << "ERROR:" << std::endl;
+				for (auto it = msg.begin(); it != msg.end(); ++it)
+					std::cerr << *it << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
 	} else if (arg_parser.get<std::string>("prob") == "MLBPNF") {
 		/*****************************************************************************************/
 		/** Multi-Level Bin Packing Problem - Network Flow ***************************************/
@@ -146,6 +433,7 @@ int main(int argc, char* argv[])
 		MIPSolver<MLBP> mip_solver;
 		mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
 		mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should always be one for our experiments
+		mip_solver.setRelaxAndFix(arg_parser.get<std::string>("alg") == "RF");  // fix the MIP level by level
 
 		mip_solver.setFormulation<MLBPNFFormulation>();  // set MIP formulation
 
@@ -153,6 +441,20 @@ int main(int argc, char* argv[])
 		auto status = mip_solver.run(inst, sol);  /** run MIP solver **/
 		/**************************************************************/
 
+		if (status == SolverStatus::Feasible && arg_parser.get<int>("lns") > 0) {
+			// polish the solution by solving sub-MIPs of the network flow formulation in parallel
+			LNSSolver<MLBP> lns_solver;
+			lns_solver.setTimeLimit(arg_parser.get<int>("lns"));
+			lns_solver.setThreads(arg_parser.get<int>("threads"));  // number of sub-MIPs solved in parallel
+			lns_solver.setFormulation<MLBPNFFormulation>();
+
+			/**************************************************************/
+			status = lns_solver.run(inst, sol);  /** run LNS **************/
+			/**************************************************************/
+
+			SOUT() << "LNS rounds:\t" << lns_solver.rounds() << std::endl;
+		}
+
 		if (status == MIPSolver<MLBP>::Feasible || status == MIPSolver<MLBP>::Optimal) {
 			SOUT() << std::endl;
 			SOUT() << "# best solution:" << sol << std::endl;
@@ -169,6 +471,75 @@ int main(int argc, char* argv[])
 				std::cerr << *it << std::endl;
 			return EXIT_FAILURE;
 		}
+	} else if (arg_parser.get<std::string>("prob") == "MLBPTW" && !arg_parser.get<std::string>("stream").empty()) {
+	/*****************************************************************************************/
+	/** Multi-Level Bin Packing Problem with Time Windows - online packing *******************/
+	/*****************************************************************************************/
+	Instance<MLBPTW> pool(instance_filename);  // read MLBPTW instance, the bins are known in advance
+
+	// source of the arriving items
+	const std::string source = arg_parser.get<std::string>("stream");
+	std::stringstream replay;
+	std::ifstream file;
+	if (source == "replay") {
+		std::vector<int> order(pool.B[0]);
+		std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return pool.e[a] < pool.e[b]; });
+		for (int i : order)
+			replay << pool.s[0][i] << " " << pool.e[i] << " " << pool.l[i] << "\n";
+	} else if (source != "-") {
+		file.open(source);
+		if (!file.is_open()) {
+			std::cerr << "ERROR: Cannot open stream " << source << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	std::istream& in = source == "-" ? std::cin : source == "replay" ? static_cast<std::istream&>(replay) : file;
+
+	std::vector<std::vector<int> > bins(pool.B);
+	bins[0].clear();
+	Instance<MLBPTW> inst(pool, bins);  // the arriving items are appended
+	Solution<MLBPTW> sol(inst);
+
+	SOUT() << "instance: " << instance_filename << std::endl;
+	SOUT() << "stream: " << source << std::endl;
+
+	// setup online packing
+	MLBPTWStreamSolver stream_solver;
+	stream_solver.setLookahead(arg_parser.get<int>("lookahead"));
+
+	/**************************************************************/
+	auto status = stream_solver.run(in, inst, sol);  /** run online packing */
+	/**************************************************************/
+
+	SOUT() << "streamed items:\t" << inst.n[0] << std::endl;
+	SOUT() << "committed groups:\t" << stream_solver.committed() << std::endl;
+	SOUT() << "decision latency [us]:\tmean " << stream_solver.latencyMean() << ", median " << stream_solver.latency(0.5)
+	       << ", p99 " << stream_solver.latency(0.99) << ", max " << stream_solver.latency(1.0) << std::endl;
+
+	if (status == SolverStatus::Feasible) {
+		SOUT() << std::endl;
+		SOUT() << "# online solution:" << sol << std::endl;
+		SOUT() << "online objective value:\t" << inst.objective(sol) << std::endl;
+
+		// competitive ratio against the offline sweep over all streamed items and against the lower bound
+		Solution<MLBPTW> offline(inst);
+		if (MLBPTWSweepSolver().run(inst, offline) == SolverStatus::Feasible) {
+			SOUT() << "offline objective value:\t" << inst.objective(offline) << std::endl;
+			SOUT() << "competitive ratio (offline):\t" << (double)inst.objective(sol) / std::max(1, inst.objective(offline)) << std::endl;
+		}
+		const int lower_bound = LowerBound<MLBPTW>::compute(inst);
+		SOUT() << "combinatorial lower bound:\t" << lower_bound << std::endl;
+		SOUT() << "competitive ratio (lower bound):\t" << (double)inst.objective(sol) / std::max(1, lower_bound) << std::endl;
+	}
+
+	// check if solution is feasible
+	std::vector<std::string> msg;
+	if (!SolutionVerifier<MLBPTW>::verify(inst, sol, &msg)) {
+		std::cerr << "ERROR:" << std::endl;
+		for (auto it = msg.begin(); it != msg.end(); ++it)
+			std::cerr << *it << std::endl;
+		return EXIT_FAILURE;
+	}
 	} else if (arg_parser.get<std::string>("prob") == "MLBPTW") {
 	/*****************************************************************************************/
 	/** Multi-Level Bin Packing Problem with Time Windows ************************************/
@@ -180,18 +551,158 @@ int main(int argc, char* argv[])
 
 	Solution<MLBPTW> sol(inst);  // create empty MLBP solution
 
-	// setup MIP solver
-	MIPSolver<MLBPTW> mip_solver;
-	mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
-	mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should always be one for our experiments
+	// fast combinatorial lower bound, the heuristics stop as soon as they reach it
+	const int lower_bound = LowerBound<MLBPTW>::compute(inst);
+	sol.db = lower_bound;
+	SOUT() << "combinatorial lower bound:\t" << lower_bound << std::endl;
+
+	SolverStatus::Status status;
+	if (arg_parser.get<int>("horizon") > 0) {
+		// setup rolling horizon over windows of e, each window solves the MIP formulation
+		MLBPTWRollingHorizonSolver rh_solver;
+		rh_solver.setHorizon(arg_parser.get<int>("horizon"));
+		rh_solver.setStep(arg_parser.get<int>("step") > 0 ? arg_parser.get<int>("step") : std::max(1, arg_parser.get<int>("horizon") / 2));
+		rh_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+		rh_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads by CPLEX
+		rh_solver.setFormulation<MLBPTWFormulation>();
 
-	mip_solver.setFormulation<MLBPTWFormulation>();  // set MIP formulation
+		/**************************************************************/
+		status = rh_solver.run(inst, sol);  /** run rolling horizon ***/
+		/**************************************************************/
 
-	/**************************************************************/
-	auto status = mip_solver.run(inst, sol);  /** run MIP solver **/
-	/**************************************************************/
+		for (const auto& window : rh_solver.windows())
+			SOUT() << "window " << window.start << ":\t" << window.items << " items, " << window.fixed << " fixed, " << window.time << "s, objective " << window.objective
+			       << ", gap " << (window.db < 0 ? 100.0 : window.objective > 0 ? (double)(window.objective - window.db) / window.objective * 100.0 : 0.0) << "%" << std::endl;
+		SOUT() << "rolling horizon windows:\t" << rh_solver.windows().size() << std::endl;
+	} else if (arg_parser.get<int>("grid") > 1 || arg_parser.get<int>("geometric") > 0) {
+		// setup size quantisation, the coarse instance is solved by FFD, BFD, SWEEP, BB or MIP (see solveWith)
+		QuantisedSolver<MLBPTW> q_solver(arg_parser.get<int>("grid") > 1 ? QuantisedSolver<MLBPTW>::Grid : QuantisedSolver<MLBPTW>::Geometric,
+		                                 arg_parser.get<int>("grid") > 1 ? arg_parser.get<int>("grid") : 1.0 + arg_parser.get<int>("geometric") / 100.0);
+		const std::string alg = arg_parser.get<std::string>("alg");
+		const int time = arg_parser.get<int>("ttime"), threads = arg_parser.get<int>("threads");
+		q_solver.setSolver([alg, time, threads](const Instance<MLBPTW>& coarse, Solution<MLBPTW>& coarse_sol) {
+			return solveWith(alg, coarse, coarse_sol, time, threads);
+		});
 
-	if (status == MIPSolver<MLBPTW>::Feasible || status == MIPSolver<MLBPTW>::Optimal) {
+		/**************************************************************/
+		status = q_solver.run(inst, sol);  /** run quantisation *******/
+		/**************************************************************/
+
+		SOUT() << "quantised sizes:\t" << q_solver.classes() << std::endl;
+		SOUT() << "inflation of the sizes:\t" << q_solver.inflation() << std::endl;
+		SOUT() << "proven gap:\t" << q_solver.gap() * 100.0 << "%" << std::endl;
+	} else if (arg_parser.get<int>("decomp")) {
+		// setup decomposition into the components of the time windows, each component runs on one thread
+		MLBPTWDecompositionSolver dec_solver;
+		dec_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+		dec_solver.setThreads(arg_parser.get<int>("threads"));  // number of components solved in parallel
+		const std::string alg = arg_parser.get<std::string>("alg");
+		dec_solver.setSolver([alg](const Instance<MLBPTW>& sub, Solution<MLBPTW>& sub_sol, int time) {
+			return solveWith(alg, sub, sub_sol, time, 1);  // one thread per component
+		});
+
+		/**************************************************************/
+		status = dec_solver.run(inst, sol);  /** run decomposition ****/
+		/**************************************************************/
+
+		SOUT() << "time-window components:\t" << dec_solver.components() << (dec_solver.exact() ? " (exact split)" : " (heuristic split)") << std::endl;
+	} else if (arg_parser.get<std::string>("alg") == "CG") {
+		// setup column generation solver
+		MLBPTWCGSolver cg_solver;
+		cg_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+		cg_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads by CPLEX
+
+		/**************************************************************/
+		status = cg_solver.run(inst, sol);  /** run CG solver *********/
+		/**************************************************************/
+
+		SOUT() << "generated columns:\t" << cg_solver.columns() << std::endl;
+	} else if (arg_parser.get<std::string>("alg") == "FFD" || arg_parser.get<std::string>("alg") == "BFD") {
+		// setup level-wise fit decreasing heuristic
+		FitDecreasingSolver<MLBPTW> fd_solver(arg_parser.get<std::string>("alg") == "FFD" ? FitDecreasingSolver<MLBPTW>::FirstFit : FitDecreasingSolver<MLBPTW>::BestFit);
+
+		/**************************************************************/
+		status = fd_solver.run(inst, sol);  /** run heuristic *********/
+		/**************************************************************/
+	} else if (arg_parser.get<std::string>("alg") == "SWEEP") {
+		// setup time-window sweep heuristic
+		MLBPTWSweepSolver sweep_solver;
+
+		/**************************************************************/
+		status = sweep_solver.run(inst, sol);  /** run heuristic ******/
+		/**************************************************************/
+	} else if (arg_parser.get<std::string>("alg") == "MA") {
+		// setup memetic algorithm
+		MemeticSolver<MLBPTW> ma_solver;
+		if (arg_parser.get<int>("ttime") > 0)
+			ma_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; default 60 seconds
+		ma_solver.setThreads(arg_parser.get<int>("threads"));  // number of islands, one per thread
+
+		/**************************************************************/
+		status = ma_solver.run(inst, sol);  /** run memetic algorithm */
+		/**************************************************************/
+
+		SOUT() << "generations:\t" << ma_solver.generations() << std::endl;
+	} else if (arg_parser.get<std::string>("alg") == "BB") {
+		// setup branch-and-bound
+		BranchAndBoundSolver<MLBPTW> bb_solver;
+		bb_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+		bb_solver.setThreads(arg_parser.get<int>("threads"));  // number of threads sharing the search tree
+
+		/**************************************************************/
+		status = bb_solver.run(inst, sol);  /** run branch-and-bound **/
+		/**************************************************************/
+
+		SOUT() << "branch-and-bound nodes:\t" << bb_solver.nodes() << std::endl;
+	} else {
+		// setup MIP solver
+		MIPSolver<MLBPTW> mip_solver;
+		mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
+		mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should always be one for our experiments
+		mip_solver.setRelaxAndFix(arg_parser.get<std::string>("alg") == "RF");  // fix the MIP level by level
+
+		if (arg_parser.get<std::string>("alg") == "BD")
+			mip_solver.setFormulation<BendersFormulation<MLBPTW> >(arg_parser.get<int>("threads"));  // set Benders master, subproblems are solved in parallel
+		else
+			mip_solver.setFormulation<MLBPTWFormulation>();  // set MIP formulation
+
+		/**************************************************************/
+		status = mip_solver.run(inst, sol);  /** run MIP solver *******/
+		/**************************************************************/
+	}
+
+	// stop early if the solution meets the combinatorial lower bound
+	sol.db = std::max(sol.db, lower_bound);
+	if (status == SolverStatus::Feasible && inst.objective(sol) <= sol.db)
+		status = SolverStatus::Optimal;
+
+	if (status == SolverStatus::Feasible && arg_parser.get<int>("vns") > 0) {
+		// improve the solution by local search on the bin assignment
+		VNSSolver<MLBPTW> vns_solver;
+		vns_solver.setTimeLimit(arg_parser.get<int>("vns"));
+
+		/**************************************************************/
+		status = vns_solver.run(inst, sol);  /** run VNS **************/
+		/**************************************************************/
+
+		SOUT() << "VNS iterations:\t" << vns_solver.iterations() << std::endl;
+	}
+
+	if (status == SolverStatus::Feasible && arg_parser.get<int>("lns") > 0) {
+		// polish the solution by solving sub-MIPs in parallel
+		LNSSolver<MLBPTW> lns_solver;
+		lns_solver.setTimeLimit(arg_parser.get<int>("lns"));
+		lns_solver.setThreads(arg_parser.get<int>("threads"));  // number of sub-MIPs solved in parallel
+		lns_solver.setFormulation<MLBPTWFormulation>();
+
+		/**************************************************************/
+		status = lns_solver.run(inst, sol);  /** run LNS **************/
+		/**************************************************************/
+
+		SOUT() << "LNS rounds:\t" << lns_solver.rounds() << std::endl;
+	}
+
+	if (status == SolverStatus::Feasible || status == SolverStatus::Optimal) {
 		SOUT() << std::endl;
 		SOUT() << "# best solution:" << sol << std::endl;
 		SOUT() << "best objective value:\t" << inst.objective(sol) << std::endl;
@@ -207,6 +718,50 @@ int main(int argc, char* argv[])
 			std::cerr << *it << std::endl;
 		return EXIT_FAILURE;
 	}
+
+	if (!arg_parser.get<std::string>("delta").empty()) {
+		// re-plan after a change of the instance, starting from the solution above
+		InstanceDelta<MLBPTW> delta;
+		try {
+			delta.read(arg_parser.get<std::string>("delta"));
+		} catch (const std::exception& exp) {
+			std::cerr << "ERROR: " << exp.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::vector<std::vector<int> > map;
+		Instance<MLBPTW> next_inst = delta.apply(inst, map);  // map of the items and bins to the new instance
+		Solution<MLBPTW> next_sol(next_inst);
+		next_sol.db = LowerBound<MLBPTW>::compute(next_inst);
+
+		IncrementalSolver<MLBPTW> inc_solver;
+		if (arg_parser.get<int>("resolve") > 0) {
+			inc_solver.setFormulation<MLBPTWFormulation>();  // re-solve the affected subtrees
+			inc_solver.setTimeLimit(arg_parser.get<int>("resolve"));
+		}
+		inc_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads by CPLEX
+
+		int delta_ticket = LuTze::start();
+		/**************************************************************/
+		status = inc_solver.run(next_inst, sol, delta, map, next_sol);  /** run re-planning **/
+		/**************************************************************/
+
+		SOUT() << std::endl;
+		SOUT() << "re-planning time:\t" << LuTze::end(delta_ticket) << std::endl;
+		SOUT() << "reinserted items:\t" << inc_solver.reinserted() << std::endl;
+		SOUT() << "affected top-level bins:\t" << inc_solver.affected() << std::endl;
+		if (status == SolverStatus::Feasible || status == SolverStatus::Optimal) {
+			SOUT() << "# re-planned solution:" << next_sol << std::endl;
+			SOUT() << "re-planned objective value:\t" << next_inst.objective(next_sol) << std::endl;
+			SOUT() << "re-planned dual bound value:\t" << next_sol.db << std::endl;
+		}
+
+		if (!SolutionVerifier<MLBPTW>::verify(next_inst, next_sol, &msg)) {
+			std::cerr << "ERROR:" << std::endl;
+			for (auto it = msg.begin(); it != msg.end(); ++it)
+				std::cerr << *it << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
 	}
 	else if (arg_parser.get<std::string>("prob") == "MLBPTWNF") {
 	/*****************************************************************************************/
@@ -223,6 +778,7 @@ int main(int argc, char* argv[])
 	MIPSolver<MLBPTW> mip_solver;
 	mip_solver.setTimeLimit(arg_parser.get<int>("ttime"));  // set time limit; 0 -> no time limit
 	mip_solver.setThreads(arg_parser.get<int>("threads"));  // number of used threads, should always be one for our experiments
+	mip_solver.setRelaxAndFix(arg_parser.get<std::string>("alg") == "RF");  // fix the MIP level by level
 
 	mip_solver.setFormulation<MLBPTWNFFormulation>();  // set MIP formulation
 
@@ -230,6 +786,20 @@ int main(int argc, char* argv[])
 	auto status = mip_solver.run(inst, sol);  /** run MIP solver **/
 	/**************************************************************/
 
+	if (status == SolverStatus::Feasible && arg_parser.get<int>("lns") > 0) {
+		// polish the solution by solving sub-MIPs of the network flow formulation in parallel
+		LNSSolver<MLBPTW> lns_solver;
+		lns_solver.setTimeLimit(arg_parser.get<int>("lns"));
+		lns_solver.setThreads(arg_parser.get<int>("threads"));  // number of sub-MIPs solved in parallel
+		lns_solver.setFormulation<MLBPTWNFFormulation>();
+
+		/**************************************************************/
+		status = lns_solver.run(inst, sol);  /** run LNS **************/
+		/**************************************************************/
+
+		SOUT() << "LNS rounds:\t" << lns_solver.rounds() << std::endl;
+	}
+
 	if (status == MIPSolver<MLBPTW>::Feasible || status == MIPSolver<MLBPTW>::Optimal) {
 		SOUT() << std::endl;
 		SOUT() << "# best solution:" << sol << std::endl;
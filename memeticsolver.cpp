@@ -0,0 +1,402 @@
+#include "memeticsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "users.h"
+#include "segmenttree.h"
+#include "openbins.h"
+#include "vnssolver.h"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+
+namespace {
+
+const int MAX_TRIES = 32;  // open bins checked for a compatible time window before a new bin is opened
+
+// permutation of the items, bounds: end of the items of each top-level bin (best filled first)
+struct Individual
+{
+	std::vector<int> order;
+	std::vector<int> bounds;
+	long cost;
+};
+
+// lock-free single-producer/single-consumer ring buffer for migrants
+class MigrationQueue
+{
+public:
+	MigrationQueue() : head(0), tail(0) { }
+
+	bool push(const Individual& ind)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) == CAPACITY)
+			return false;  // full, the migrant is dropped
+		slots[t % CAPACITY] = ind;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(Individual& ind)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire))
+			return false;
+		ind = std::move(slots[h % CAPACITY]);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	static const size_t CAPACITY = 4;
+	Individual slots[CAPACITY];
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+};
+
+// multi-level first-fit in the order of a permutation
+template<typename ProbT>
+class Decoder
+{
+public:
+	Decoder(const Instance<ProbT>& inst) : inst(inst), m(inst.m), sorted(m + 1), cap(m + 1), position(m + 1), slot(m + 1), residual(m + 1), top_of(m + 1), opened(m + 1)
+	{
+		ratio_init.emplace_back(0);
+		for (int k : inst.M) {
+			sorted[k] = inst.B[k];
+			std::sort(sorted[k].begin(), sorted[k].end(), [&](int a, int b) { return inst.w[k][a] < inst.w[k][b]; });
+			cap[k].resize(inst.n[k]);
+			position[k].resize(inst.n[k]);
+			ratio_init.emplace_back(inst.n[k]);
+			for (int q = 0; q < inst.n[k]; q++) {
+				int j = sorted[k][q];
+				cap[k][q] = inst.w[k][j];
+				position[k][j] = q;
+				ratio_init[k].set(q, (double)inst.c[k][j] / std::max(1, inst.w[k][j]));
+			}
+			slot[k].assign(inst.n[k], -1);
+			residual[k].assign(inst.n[k], 0);
+			top_of[k].assign(inst.n[k], -1);
+		}
+		u.assign(inst.n[m], 0);
+		lo.assign(inst.n[m], 0);
+	}
+
+	bool decode(const std::vector<int>& order, Solution<ProbT>& sol)
+	{
+		ratio = ratio_init;
+		open.assign(m + 1, OpenBins());
+		for (int k : inst.M) {
+			for (int j : opened[k])
+				slot[k][j] = -1;
+			opened[k].clear();
+		}
+		for (int k = 0; k < m; k++)
+			sol.item_to_bins[k].assign(inst.n[k], -1);
+		sol.total_cost = 0;
+		sol.total_bins = 0;
+
+		for (int i : order) {
+			int e = 0, l = 0;
+			if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+				e = inst.e[i];
+				l = inst.l[i];
+			}
+			if (!place(0, i, inst.s[0][i], e, l, sol))
+				return false;
+		}
+
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			for (int i : inst.B[0])
+				sol.total_cost += inst.p * (u[top_of[1][sol.item_to_bins[0][i]]] - inst.e[i]);
+		return true;
+	}
+
+private:
+	// places x of level k (with the given size and time window) into a bin of level k+1
+	bool place(int k, int x, int size, int e, int l, Solution<ProbT>& sol)
+	{
+		const int lvl = k + 1;
+		for (int q = open[lvl].firstFit(size), tries = 0; q >= 0 && tries < MAX_TRIES; q = open[lvl].firstFit(size, q + 1), tries++) {
+			int j = opened[lvl][q];
+			if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+				int t = top_of[lvl][j];
+				if (std::max(u[t], e) > std::min(lo[t], l))
+					continue;
+				u[t] = std::max(u[t], e);
+				lo[t] = std::min(lo[t], l);
+			}
+			assign(k, x, lvl, j, size, sol);
+			return true;
+		}
+
+		// open the unused bin with the smallest cost per capacity holding x
+		int q = ratio[lvl].argmin((int)(std::lower_bound(cap[lvl].begin(), cap[lvl].end(), size) - cap[lvl].begin()));
+		if (q < 0)
+			return false;
+		int j = sorted[lvl][q];
+		ratio[lvl].remove(q);
+		slot[lvl][j] = open[lvl].add(-1);
+		opened[lvl].push_back(j);
+		residual[lvl][j] = inst.w[lvl][j];
+		sol.total_cost += inst.c[lvl][j];
+		sol.total_bins++;
+
+		if (lvl == m) {
+			top_of[m][j] = j;
+			u[j] = e;
+			lo[j] = l;
+		} else {
+			if (!place(lvl, j, inst.s[lvl][j], e, l, sol))
+				return false;
+			top_of[lvl][j] = top_of[lvl + 1][sol.item_to_bins[lvl][j]];
+		}
+		assign(k, x, lvl, j, size, sol);
+		return true;
+	}
+
+	void assign(int k, int x, int lvl, int j, int size, Solution<ProbT>& sol)
+	{
+		sol.item_to_bins[k][x] = j;
+		residual[lvl][j] -= size;
+		open[lvl].set(slot[lvl][j], residual[lvl][j]);
+	}
+
+	const Instance<ProbT>& inst;
+	const int m;
+
+	std::vector<std::vector<int> > sorted, cap, position;  // bins of each level sorted by capacity
+	std::vector<MinTree> ratio_init, ratio;                 // cost per capacity of the unused bins
+	std::vector<OpenBins> open;                             // residual capacities of the opened bins (in opening order)
+	std::vector<std::vector<int> > slot, residual, top_of;
+	std::vector<std::vector<int> > opened;
+	std::vector<int> u, lo;                                 // time window of each top-level bin
+};
+
+// permutation of sol: items grouped by top-level bins, the best filled top-level bin first
+template<typename ProbT>
+void encode(const Instance<ProbT>& inst, const Solution<ProbT>& sol, Individual& ind)
+{
+	const int m = inst.m;
+	std::vector<std::vector<std::vector<int> > > children(m + 1);
+	for (int k : inst.M)
+		children[k].assign(inst.n[k], std::vector<int>());
+	for (int k = 0; k < m; k++)
+		for (int x : inst.B[k])
+			if (sol.item_to_bins[k][x] >= 0)
+				children[k + 1][sol.item_to_bins[k][x]].push_back(x);
+
+	std::vector<int> tops;
+	for (int t : inst.B[m])
+		if (!children[m][t].empty())
+			tops.push_back(t);
+
+	// items of a subtree (depth-first) and the ratio size of the items / cost of the bins
+	std::vector<std::vector<int> > content(tops.size());
+	std::vector<double> score(tops.size());
+	for (int q = 0; q < (int)tops.size(); q++) {
+		long size = 0, cost = 0;
+		std::vector<std::pair<int, int> > stack{std::make_pair(m, tops[q])};
+		while (!stack.empty()) {
+			auto [k, x] = stack.back();
+			stack.pop_back();
+			if (k == 0) {
+				content[q].push_back(x);
+				size += inst.s[0][x];
+				continue;
+			}
+			cost += inst.c[k][x];
+			for (auto it = children[k][x].rbegin(); it != children[k][x].rend(); ++it)
+				stack.push_back(std::make_pair(k - 1, *it));
+		}
+		score[q] = (double)size / std::max(1L, cost);
+	}
+
+	std::vector<int> rank(tops.size());
+	std::iota(rank.begin(), rank.end(), 0);
+	std::sort(rank.begin(), rank.end(), [&](int a, int b) { return score[a] > score[b]; });
+
+	ind.order.clear();
+	ind.bounds.clear();
+	for (int q : rank) {
+		ind.order.insert(ind.order.end(), content[q].begin(), content[q].end());
+		ind.bounds.push_back((int)ind.order.size());
+	}
+	ind.cost = sol.total_cost;
+}
+
+// items of a random selection of the top-level bins of a (biased to the best filled), then the remaining items in the order of b
+void crossover(const Individual& a, const Individual& b, std::vector<char>& taken, std::mt19937& rng, std::vector<int>& child)
+{
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	child.clear();
+	std::fill(taken.begin(), taken.end(), 0);
+	const int groups = (int)a.bounds.size();
+	for (int q = 0, begin = 0; q < groups; begin = a.bounds[q++]) {
+		if (uniform(rng) >= 0.75 - 0.5 * q / groups)
+			continue;
+		for (int p = begin; p < a.bounds[q]; p++) {
+			child.push_back(a.order[p]);
+			taken[a.order[p]] = 1;
+		}
+	}
+	for (int i : b.order)
+		if (!taken[i])
+			child.push_back(i);
+}
+
+} // namespace
+
+
+template<typename ProbT>
+typename MemeticSolver<ProbT>::Status MemeticSolver<ProbT>::run(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto elapsed = [&start]() {
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+		return d.count();
+	};
+
+	const bool has_start = SolutionVerifier<ProbT>::verify(inst, sol);
+	std::vector<MigrationQueue> queues(m_threads);
+	std::vector<Solution<ProbT> > best(m_threads, sol);
+	std::vector<char> found(m_threads, 0);
+	std::atomic<bool> stop(false);
+	std::atomic<int> generations(0);
+
+	// base order: decreasing size (MLBP), increasing earliest starting time (MLBPTW)
+	std::vector<int> base(inst.B[0]);
+	std::sort(base.begin(), base.end(), [&](int a, int b) {
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			if (inst.e[a] != inst.e[b])
+				return inst.e[a] < inst.e[b];
+		return inst.s[0][a] != inst.s[0][b] ? inst.s[0][a] > inst.s[0][b] : a < b;
+	});
+
+	auto island = [&](int t) {
+		std::mt19937 rng(m_seed + 7919 * t);
+		Decoder<ProbT> decoder(inst);
+		Solution<ProbT> cand(inst);
+		std::vector<Individual> population;
+		std::vector<char> taken(inst.n[0]);
+		std::vector<int> child;
+
+		// decodes the permutation and applies the local search; false if the decoder ran out of bins
+		auto evaluate = [&](const std::vector<int>& order, Individual& ind) {
+			if (!decoder.decode(order, cand))
+				return false;
+			cand.db = sol.db;
+			if (m_ls_iterations > 0) {
+				VNSSolver<ProbT> vns;
+				vns.setTimeLimit(std::max(1, (int)(m_time_limit - elapsed())));
+				vns.setIterationLimit(m_ls_iterations);
+				vns.setSeed(rng());
+				if (vns.run(inst, cand) == Aborted)
+					return false;
+			}
+			encode(inst, cand, ind);
+			if (!found[t] || cand.total_cost < best[t].total_cost) {
+				best[t] = cand;
+				found[t] = 1;
+				if (cand.total_cost <= sol.db)
+					stop = true;
+			}
+			return true;
+		};
+
+		if (has_start) {
+			Individual ind;
+			encode(inst, sol, ind);
+			population.push_back(ind);
+		}
+		for (int tries = 0; (int)population.size() < m_population && tries < 4 * m_population && !stop && elapsed() < m_time_limit; tries++) {
+			// perturbed base order
+			child = base;
+			int swaps = population.empty() && t == 0 ? 0 : 1 + inst.n[0] / 10;
+			for (int q = 0; q < swaps; q++) {
+				int a = rng() % child.size();
+				int b = std::min((int)child.size() - 1, a + (int)(rng() % 16));
+				std::swap(child[a], child[b]);
+			}
+			Individual ind;
+			if (evaluate(child, ind))
+				population.push_back(ind);
+		}
+		if (population.size() < 2)
+			return;
+
+		auto worst = [&population]() {
+			return (int)(std::max_element(population.begin(), population.end(), [](const Individual& a, const Individual& b) { return a.cost < b.cost; }) - population.begin());
+		};
+		auto insert = [&](Individual& ind) {
+			for (const Individual& other : population)
+				if (other.cost == ind.cost)
+					return;  // keep the population diverse
+			int w = worst();
+			if (ind.cost < population[w].cost)
+				population[w] = std::move(ind);
+		};
+		auto tournament = [&]() -> const Individual& {
+			const Individual& a = population[rng() % population.size()];
+			const Individual& b = population[rng() % population.size()];
+			return a.cost <= b.cost ? a : b;
+		};
+
+		for (int generation = 1; !stop && elapsed() < m_time_limit; generation++) {
+			const Individual& a = tournament();
+			const Individual& b = tournament();
+			crossover(a, b, taken, rng, child);
+			if (rng() % 5 == 0)
+				for (int q = 0; q < 1 + (int)(rng() % 4); q++)
+					std::swap(child[rng() % child.size()], child[rng() % child.size()]);
+
+			Individual ind;
+			if (evaluate(child, ind))
+				insert(ind);
+			generations++;
+
+			if (m_threads > 1 && generation % m_migration == 0) {
+				queues[(t + 1) % m_threads].push(*std::min_element(population.begin(), population.end(), [](const Individual& x, const Individual& y) { return x.cost < y.cost; }));
+				Individual migrant;
+				while (queues[t].pop(migrant))
+					insert(migrant);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < m_threads; t++)
+		threads.emplace_back(island, t);
+	island(0);
+	for (auto& thread : threads)
+		thread.join();
+	m_generations = generations;
+
+	int winner = -1;
+	for (int t = 0; t < m_threads; t++)
+		if (found[t] && (winner < 0 || best[t].total_cost < best[winner].total_cost))
+			winner = t;
+	if (winner >= 0 && (!has_start || best[winner].total_cost < sol.total_cost)) {
+		int db = sol.db;
+		sol = best[winner];
+		sol.db = db;
+	}
+
+	if (winner < 0 && !has_start) {
+		HEU_OUT(WARN) << "memetic algorithm: no feasible solution found" << std::endl;
+		return Aborted;
+	}
+	HEU_OUT(INFO) << "memetic algorithm: " << m_generations << " generations on " << m_threads << " islands, objective value " << sol.total_cost << std::endl;
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+// Instantiate all required memetic solver classes
+template class MemeticSolver<MLBP>;
+template class MemeticSolver<MLBPTW>;
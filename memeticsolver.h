@@ -0,0 +1,59 @@
+#ifndef __MEMETIC_SOLVER_H__
+#define __MEMETIC_SOLVER_H__
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Parallel memetic algorithm (island model) for MLBP and MLBPTW without CPLEX.
+ * Each thread evolves its own population, individuals are permutations of the items:
+ *
+ *  *) decoder   -> multi-level first-fit in the order of the permutation, a new bin is the unused bin
+ *                  with the smallest cost per capacity holding the element (for MLBPTW only bins whose
+ *                  top-level bin has a compatible time window are considered)
+ *  *) crossover -> the items of the best filled top-level bins (size of the items / cost of the bins)
+ *                  of the first parent come first, followed by the remaining items in the order of the
+ *                  second parent, such that the decoder rebuilds the well-filled bins
+ *  *) mutation  -> random swaps in the permutation and a short variable neighbourhood search (see VNSSolver),
+ *                  the improved solution is written back into the permutation (grouped by top-level bins)
+ *
+ *  Every m_migration generations, the best individual of each island migrates to the next island
+ *  (ring topology) through a lock-free single-producer/single-consumer queue and replaces the worst
+ *  individual there. The search is reproducible for a given seed only with a single thread.
+ */
+template<typename ProbT>
+class MemeticSolver : public SolverStatus
+{
+public:
+	MemeticSolver() : m_time_limit(60), m_threads(1), m_seed(0), m_population(20), m_migration(10), m_ls_iterations(20), m_generations(0) { }
+
+	void setTimeLimit(int time) { m_time_limit = time; }                  // in seconds
+	void setThreads(int number) { m_threads = std::max(1, number); }      // number of islands, each island runs in its own thread
+	void setSeed(unsigned int seed) { m_seed = seed; }
+	void setPopulation(int number) { m_population = std::max(2, number); } // individuals per island
+	void setMigration(int number) { m_migration = std::max(1, number); }   // generations between two migrations
+	void setLocalSearch(int number) { m_ls_iterations = number; }          // VNS iterations per offspring
+
+	// sol may contain a feasible start solution, which is added to each island
+	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
+	int generations() const { return m_generations; }  // total number of generations (all islands) from last run(...) call
+
+private:
+	int m_time_limit;
+	int m_threads;
+	unsigned int m_seed;
+	int m_population;
+	int m_migration;
+	int m_ls_iterations;
+	int m_generations;
+};
+
+#endif // __MEMETIC_SOLVER_H__
@@ -0,0 +1,207 @@
+#include "minbinslacksolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+#include "segmenttree.h"
+
+#include <numeric>
+
+
+MinBinSlackSolver::Status MinBinSlackSolver::run(const Instance<MLBP>& inst, Solution<MLBP>& sol)
+{
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+	sol.total_bins = 0;
+	sol.total_cost = 0;
+
+	std::vector<int> cur(inst.B[0]), next;
+	for (int k : inst.M) {
+		if (!packLevel(inst, k, cur, sol.item_to_bins[k - 1], next)) {
+			HEU_OUT(WARN) << "MBS: no unused bin of level " << k << " left" << std::endl;
+			return Aborted;
+		}
+		sol.total_bins += (int)next.size();
+		for (int j : next)
+			sol.total_cost += inst.c[k][j];
+		cur.swap(next);
+	}
+
+	HEU_OUT(INFO) << "MBS: " << sol.total_bins << " bins, cost " << sol.total_cost << std::endl;
+	return Feasible;
+}
+
+bool MinBinSlackSolver::packLevel(const Instance<MLBP>& inst, int k, const std::vector<int>& elems, std::vector<int>& assign, std::vector<int>& used) const
+{
+	const std::vector<int>& size = inst.s[k - 1];
+
+	// remaining elements by decreasing size (doubly linked list)
+	std::vector<int> order(elems);
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return size[a] != size[b] ? size[a] > size[b] : a < b; });
+	const int n = (int)order.size();
+	std::vector<int> next(n), prev(n);
+	for (int q = 0; q < n; q++) {
+		next[q] = q + 1 < n ? q + 1 : -1;
+		prev[q] = q - 1;
+	}
+	int head = n > 0 ? 0 : -1, tail = n - 1, remaining = n;
+	long total = 0;
+	for (int x : order)
+		total += size[x];
+	auto erase = [&](int q) {
+		(prev[q] >= 0 ? next[prev[q]] : head) = next[q];
+		(next[q] >= 0 ? prev[next[q]] : tail) = prev[q];
+		remaining--;
+		total -= size[order[q]];
+	};
+
+	// unused bins sorted by capacity
+	std::vector<int> bins(inst.B[k]);
+	std::sort(bins.begin(), bins.end(), [&](int a, int b) { return inst.w[k][a] < inst.w[k][b]; });
+	std::vector<int> cap(bins.size());
+	MinTree ratio((int)bins.size()), cost((int)bins.size());
+	for (int q = 0; q < (int)bins.size(); q++) {
+		cap[q] = inst.w[k][bins[q]];
+		ratio.set(q, (double)inst.c[k][bins[q]] / std::max(1, cap[q]));
+		cost.set(q, inst.c[k][bins[q]]);
+	}
+
+	std::vector<int> opened, load;  // positions in bins
+	std::vector<int> cand, sizes;
+	std::vector<char> chosen, best_chosen;
+	std::vector<std::vector<uint64_t> > stages;
+
+	while (remaining > 0) {
+		// candidates: the largest and the smallest remaining elements
+		cand.clear();
+		if (remaining <= m_candidates) {
+			for (int p = head; p >= 0; p = next[p])
+				cand.push_back(p);
+		} else {
+			int large = m_candidates - m_candidates / 4;
+			for (int p = head; p >= 0 && (int)cand.size() < large; p = next[p])
+				cand.push_back(p);
+			for (int p = tail; p >= 0 && (int)cand.size() < m_candidates; p = prev[p])
+				cand.push_back(p);
+		}
+		sizes.clear();
+		for (int p : cand)
+			sizes.push_back(size[order[p]]);
+
+		// bins holding the largest element: lowest cost per capacity among the bins the remaining elements can fill
+		// and the cheapest larger bin, the one with the lower cost per filled capacity is opened
+		int from = (int)(std::lower_bound(cap.begin(), cap.end(), size[order[head]]) - cap.begin());
+		int to = std::max(from, (int)(std::upper_bound(cap.begin(), cap.end(), total) - cap.begin()));
+		int q = -1, filled = 0;
+		double best = 0;
+		for (int option : {from < to ? ratio.argmin(from, to) : -1, cost.argmin(to)}) {
+			if (option < 0)
+				continue;
+			int sum = subsetSum(sizes, cap[option], chosen, stages);
+			double value = (double)inst.c[k][bins[option]] / std::max(1, sum);
+			if (q < 0 || value < best) {
+				q = option;
+				filled = sum;
+				best = value;
+				best_chosen.swap(chosen);
+			}
+		}
+		if (q < 0)
+			return false;
+		ratio.remove(q);
+		cost.remove(q);
+
+		for (int c = 0; c < (int)cand.size(); c++)
+			if (best_chosen[c]) {
+				assign[order[cand[c]]] = bins[q];
+				erase(cand[c]);
+			}
+		opened.push_back(q);
+		load.push_back(filled);
+	}
+
+	// downsizing: exchange each used bin for the cheapest unused bin which holds its content, largest content first
+	std::vector<int> rank(opened.size());
+	std::iota(rank.begin(), rank.end(), 0);
+	std::sort(rank.begin(), rank.end(), [&](int a, int b) { return load[a] > load[b]; });
+	std::vector<int> replace(inst.n[k], -1);
+	for (int b : rank) {
+		int q = cost.argmin((int)(std::lower_bound(cap.begin(), cap.end(), load[b]) - cap.begin()));
+		if (q < 0 || inst.c[k][bins[q]] >= inst.c[k][bins[opened[b]]])
+			continue;
+		cost.remove(q);
+		cost.set(opened[b], inst.c[k][bins[opened[b]]]);
+		replace[bins[opened[b]]] = bins[q];
+		opened[b] = q;
+	}
+
+	used.clear();
+	for (int q : opened)
+		used.push_back(bins[q]);
+	for (int x : elems)
+		if (replace[assign[x]] >= 0)
+			assign[x] = replace[assign[x]];
+	return true;
+}
+
+int MinBinSlackSolver::subsetSum(const std::vector<int>& sizes, int capacity, std::vector<char>& chosen, std::vector<std::vector<uint64_t> >& stages)
+{
+	const int n = (int)sizes.size();
+	chosen.assign(n, 0);
+
+	// everything fits
+	long total = std::accumulate(sizes.begin(), sizes.end(), 0L);
+	if (total <= capacity) {
+		std::fill(chosen.begin(), chosen.end(), 1);
+		return (int)total;
+	}
+
+	// stages[q]: bitset of the sums reachable with the first q sizes, bits > capacity are cut off
+	const int words = capacity / 64 + 1;
+	const uint64_t last_mask = capacity % 64 == 63 ? ~0ULL : (1ULL << (capacity % 64 + 1)) - 1;
+	if ((int)stages.size() < n + 1)
+		stages.resize(n + 1);
+	stages[0].assign(words, 0);
+	stages[0][0] = 1;
+
+	int used = n;
+	for (int q = 0; q < n; q++) {
+		const std::vector<uint64_t>& old = stages[q];
+		std::vector<uint64_t>& cur = stages[q + 1];
+		cur.resize(words);
+		const int shift_words = sizes[q] / 64, shift_bits = sizes[q] % 64;
+		for (int w = words - 1; w >= 0; w--) {
+			uint64_t v = old[w];
+			if (w >= shift_words) {
+				v |= old[w - shift_words] << shift_bits;
+				if (shift_bits > 0 && w > shift_words)
+					v |= old[w - shift_words - 1] >> (64 - shift_bits);
+			}
+			cur[w] = v;
+		}
+		cur[words - 1] &= last_mask;
+		if ((cur[capacity / 64] >> (capacity % 64)) & 1) {
+			used = q + 1;  // no slack left
+			break;
+		}
+	}
+
+	// largest reachable sum
+	int best = 0;
+	for (int w = words - 1; w >= 0; w--)
+		if (stages[used][w]) {
+			best = 64 * w + 63 - __builtin_clzll(stages[used][w]);
+			break;
+		}
+
+	for (int q = used, sum = best; q > 0; q--) {
+		if ((stages[q - 1][sum / 64] >> (sum % 64)) & 1)
+			continue;  // reachable without sizes[q-1]
+		chosen[q - 1] = 1;
+		sum -= sizes[q - 1];
+	}
+	for (int q = 0; q < n; q++)
+		if (sizes[q] == 0)
+			chosen[q] = 1;
+	return best;
+}
@@ -0,0 +1,45 @@
+#ifndef __MIN_BIN_SLACK_SOLVER_H__
+#define __MIN_BIN_SLACK_SOLVER_H__
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Minimum Bin Slack heuristic for the Multi-Level Bin Packing Problem.
+ * In contrast to the item-oriented fit decreasing heuristics, the levels are packed bin by bin:
+ *
+ *  *) next bin  -> the unused bin with the lowest cost per used capacity holding the largest remaining
+ *                  element (the used capacity is bounded by the total size of the remaining elements)
+ *  *) filling   -> the subset of the candidate elements (the largest and the smallest remaining ones)
+ *                  with the smallest slack, computed by a bitset subset-sum (shift-or over 64-bit words)
+ *  *) downsizing-> after a level is packed, each used bin is exchanged for the cheapest unused bin holding its content
+ *
+ *  The used bins of level k are the elements of level k+1.
+ */
+class MinBinSlackSolver : public SolverStatus
+{
+public:
+	MinBinSlackSolver() : m_candidates(48) { }
+
+	void setCandidates(int number) { m_candidates = std::max(1, number); }  // number of remaining elements considered per bin
+
+	Status run(const Instance<MLBP>& inst, Solution<MLBP>& sol);
+
+private:
+	// packs the elements of level k-1 into the bins of level k, writes item_to_bins[k-1] and returns the used bins of level k
+	bool packLevel(const Instance<MLBP>& inst, int k, const std::vector<int>& elems, std::vector<int>& assign, std::vector<int>& used) const;
+
+	// subset of sizes with the largest sum <= capacity, chosen[q]: sizes[q] is part of the subset; returns the sum
+	static int subsetSum(const std::vector<int>& sizes, int capacity, std::vector<char>& chosen, std::vector<std::vector<uint64_t> >& stages);
+
+	int m_candidates;
+};
+
+#endif // __MIN_BIN_SLACK_SOLVER_H__
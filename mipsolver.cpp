@@ -10,11 +10,13 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 
 ILOSTLBEGIN
 
 template<typename ProbT>
-MIPSolver<ProbT>::MIPSolver() : m_time_limit(0), m_threads(0), m_bab_nodes(0)
+MIPSolver<ProbT>::MIPSolver() : m_time_limit(0), m_threads(0), m_relax_and_fix(false), m_fix_sol(nullptr), m_bab_nodes(0)
 {
 	formulation = make_unique<NullFormulation<ProbT> >();
 }
@@ -34,6 +36,12 @@ typename MIPSolver<ProbT>::Status MIPSolver<ProbT>::run(const Instance<ProbT>& i
 	MIP_OUT(DBG) << "init CPLEX" << std::endl;
 
 	try {
+		if (!m_fix_sol && formulation->presolve(inst, sol)) {
+			MIP_OUT(DBG) << "solved by the formulation without CPLEX" << std::endl;
+			m_bab_nodes = 0;
+			return Optimal;
+		}
+
 		formulation->createDecisionVariables(env, inst);
 		MIP_OUT(DBG) << "created decision variables" << std::endl;
 
@@ -43,6 +51,12 @@ typename MIPSolver<ProbT>::Status MIPSolver<ProbT>::run(const Instance<ProbT>& i
 		formulation->addObjectiveFunction(env, model, inst);
 		MIP_OUT(DBG) << "created objective function" << std::endl;
 
+		if (m_fix_sol) {
+			if (!formulation->fixSolution(model, inst, *m_fix_sol, m_free))
+				throw std::runtime_error("MIP formulation does not support fixing a solution");
+			MIP_OUT(DBG) << "fixed solution outside of the neighbourhood" << std::endl;
+		}
+
 		cplex = IloCplex(model);
 		if (m_threads != 0)
 			cplex.setParam(IloCplex::Param::Threads, m_threads);
@@ -59,6 +73,9 @@ typename MIPSolver<ProbT>::Status MIPSolver<ProbT>::run(const Instance<ProbT>& i
 
 //		cplex.setParam(IloCplex::Param::MIP::Limits::Nodes, 1); // Stop after root node.
 
+		if (m_relax_and_fix)
+			return relaxAndFix(inst, sol);
+
 		MIP_OUT(DBG) << "calling CPLEX solve ..." << std::endl;
 		cplex.solve();
 		MIP_OUT(DBG) << "CPLEX finished." << std::endl;
@@ -87,11 +104,91 @@ typename MIPSolver<ProbT>::Status MIPSolver<ProbT>::run(const Instance<ProbT>& i
 
 	} catch(IloException& e) {
 		throw std::runtime_error(e.getMessage());
+	} catch(std::runtime_error& e) {
+		throw;
 	} catch(...) {
 		throw std::runtime_error("Unknown exception");
 	}
 }
 
+template<typename ProbT>
+typename MIPSolver<ProbT>::Status MIPSolver<ProbT>::relaxAndFix(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	const int stages = formulation->stages(inst);
+	if (stages == 0)
+		throw std::runtime_error("MIP formulation does not support relax-and-fix");
+
+	auto start = std::chrono::steady_clock::now();
+
+	// relax the variables of all stages except the first one
+	std::vector<IloNumVarArray> vars(stages);
+	std::vector<IloConversion> relaxation(stages);
+	for (int stage = 0; stage < stages; stage++) {
+		vars[stage] = IloNumVarArray(env);
+		formulation->addStageVariables(vars[stage], inst, stage);
+		if (stage > 0) {
+			relaxation[stage] = IloConversion(env, vars[stage], ILOFLOAT);
+			model.add(relaxation[stage]);
+		}
+	}
+	MIP_OUT(DBG) << "relax-and-fix with " << stages << " stages" << std::endl;
+
+	m_bab_nodes = 0;
+	double db = 0.0;
+	for (int stage = 0; stage < stages; stage++) {
+		if (stage > 0)
+			model.remove(relaxation[stage]);  // variables of this stage become integral again
+
+		// split the remaining time equally among the remaining stages
+		if (m_time_limit != 0) {
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			cplex.setParam(IloCplex::Param::TimeLimit, std::max(1.0, (m_time_limit - elapsed.count()) / (stages - stage)));
+		}
+
+		cplex.solve();
+		IloAlgorithm::Status stat = cplex.getStatus();
+		m_bab_nodes += (int)cplex.getNnodes();
+		MIP_OUT(DBG) << "stage " << stage << ": CPLEX status: " << stat << std::endl;
+
+		if (stat != IloAlgorithm::Optimal && stat != IloAlgorithm::Feasible) {
+			if (stat == IloAlgorithm::Infeasible && stage == 0)
+				throw std::runtime_error("Intance is infeasible");
+			MIP_OUT(FATAL) << "relax-and-fix found no feasible solution at stage " << stage << std::endl;
+			return Aborted;
+		}
+
+		// the first stage is a relaxation of the original problem, hence its bound is valid
+		if (stage == 0)
+			db = cplex.getBestObjValue();
+
+		// fix the variables of this stage to their current values
+		IloNumArray values(env);
+		cplex.getValues(values, vars[stage]);
+		for (int q = 0; q < vars[stage].getSize(); q++) {
+			double v = std::round(values[q]);
+			vars[stage][q].setBounds(v, v);
+		}
+		values.end();
+		MIP_OUT(DBG) << "stage " << stage << ": objective value " << cplex.getObjValue() << ", fixed " << vars[stage].getSize() << " variables" << std::endl;
+	}
+
+	formulation->extractSolution(cplex, inst, sol);
+	sol.db = (int)db;
+	MIP_OUT(TRACE) << "Solution: \n" << sol << std::endl;
+	MIP_OUT(DBG) << "Objective value: " << cplex.getObjValue() << std::endl;
+	MIP_OUT(DBG) << "Lower Bound: " << db << std::endl;
+
+	// fixing decisions stage by stage is error-prone, hence always verify the final solution
+	std::vector<std::string> msg;
+	if (!SolutionVerifier<ProbT>::verify(inst, sol, &msg)) {
+		for (const std::string& m : msg)
+			MIP_OUT(FATAL) << m << std::endl;
+		return Aborted;
+	}
+
+	return cplex.getObjValue() <= db + 1e-6 ? Optimal : Feasible;
+}
+
 template<typename ProbT>
 void MIPSolver<ProbT>::initCplex()
 {
@@ -105,6 +202,28 @@ void MIPSolver<ProbT>::initCplex()
 	}
 }
 
+template<typename ProbT>
+int MIPFormulation<ProbT>::fixAssignment(IloArray<IloArray<IloNumVarArray> > x, const Instance<ProbT>& inst, const Solution<ProbT>& sol, const std::vector<std::vector<char> >& free)
+{
+	// the assignment constraints force all other x_{kij} of a fixed item/bin to 0
+	int count = 0;
+	for (int k = 0; k < inst.m; k++) {
+		for (int i : inst.B[k]) {
+			int j = sol.item_to_bins[k][i];
+			if (!free[k][i] && j >= 0) {
+				x[k][i][j].setLB(1);
+				count++;
+			}
+		}
+	}
+	MLB_OUT(TRACE) << "fixed " << count << " x_{kij} variables" << std::endl;
+	return count;
+}
+
+// Instantiate the helpers of the formulations with assignment variables
+template int MIPFormulation<MLBP>::fixAssignment(IloArray<IloArray<IloNumVarArray> >, const Instance<MLBP>&, const Solution<MLBP>&, const std::vector<std::vector<char> >&);
+template int MIPFormulation<MLBPTW>::fixAssignment(IloArray<IloArray<IloNumVarArray> >, const Instance<MLBPTW>&, const Solution<MLBPTW>&, const std::vector<std::vector<char> >&);
+
 // Instantiate all required MIP solver classes
 template class MIPSolver<BP>;
 template class MIPSolver<MLBP>;
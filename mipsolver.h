@@ -2,7 +2,9 @@
 #define __MIP_SOLVER_H__
 
 #include <ilcplex/ilocplex.h>
+#include <vector>
 #include "problems.h"
+#include "solverstatus.h"
 
 
 template<typename> struct Instance;
@@ -17,6 +19,22 @@ public:
 	virtual void addObjectiveFunction(IloEnv env, IloModel model, const Instance<ProbT>& inst) = 0;
 	virtual void addUserCallbacks(IloEnv env, IloModel model, IloCplex cplex, const Instance<ProbT>& inst) { }
 	virtual void extractSolution(IloCplex cplex, const Instance<ProbT>& inst, Solution<ProbT>& sol) = 0;
+
+	// called before the model is built: returns true if sol is already proven optimal (sol.db set), no model is solved then
+	virtual bool presolve(const Instance<ProbT>& inst, Solution<ProbT>& sol) { return false; }
+
+	// relax-and-fix: number of stages (0: not supported) and the integer variables that are fixed at the given stage
+	virtual int stages(const Instance<ProbT>& inst) const { return 0; }
+	virtual void addStageVariables(IloNumVarArray vars, const Instance<ProbT>& inst, int stage) { }
+
+	// neighbourhood search: fixes the packing of all items/bins of sol except the free ones (free[k][i] for item/bin i of level k),
+	// returns false if not supported
+	virtual bool fixSolution(IloModel model, const Instance<ProbT>& inst, const Solution<ProbT>& sol, const std::vector<std::vector<char> >& free) { return false; }
+
+protected:
+	// fixSolution() of the formulations with assignment variables x_{kij}: fixes x_{kij} = 1 for the packing of sol
+	// of each item/bin which is not free, returns the number of fixed variables
+	static int fixAssignment(IloArray<IloArray<IloNumVarArray> > x, const Instance<ProbT>& inst, const Solution<ProbT>& sol, const std::vector<std::vector<char> >& free);
 };
 
 
@@ -38,17 +56,9 @@ public:
  * See bpformulation.h for an example.
  */
 template<typename ProbT>
-class MIPSolver
+class MIPSolver : public SolverStatus
 {
 public:
-	enum Status
-	{
-		Optimal,     // Returned solution is proven optimal
-		Feasible,    // Returned solution is feasible
-		Infeasible,  // Instance is infeasible
-		Aborted      // There is no feasible solution due to time limits or memeory limits
-	};
-
 	MIPSolver();
 	~MIPSolver();
 
@@ -63,6 +73,10 @@ public:
 
 	void setTimeLimit(int time) { m_time_limit = time; }
 	void setThreads(int number) { m_threads = number;  }
+	void setRelaxAndFix(bool enable) { m_relax_and_fix = enable; }  // solve stage by stage, see relaxAndFix()
+
+	// solve only the neighbourhood of sol given by the free items/bins, see MIPFormulation::fixSolution()
+	void setFixing(const Solution<ProbT>* sol, const std::vector<std::vector<char> >& free) { m_fix_sol = sol; m_free = free; }
 
 	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
 
@@ -71,6 +85,11 @@ public:
 protected:
 	void initCplex();
 
+	// Relax-and-fix heuristic: only the variables of the first stage of the formulation are integral,
+	// the variables of all further stages are relaxed. After each solve, the variables of the current
+	// stage are fixed by their bounds and the next stage becomes integral, reusing the same model.
+	Status relaxAndFix(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
 private:
 	IloEnv env;
 	IloModel model;
@@ -79,6 +98,10 @@ private:
 	std::unique_ptr<MIPFormulation<ProbT> > formulation;
 	int m_time_limit;  // in seconds -> 0: no time limit
 	int m_threads;     // number of used threads, 0: default cplex setting
+	bool m_relax_and_fix;
+
+	const Solution<ProbT>* m_fix_sol;           // solution fixed outside of the neighbourhood, nullptr: no fixing
+	std::vector<std::vector<char> > m_free;     // free items/bins for each level
 
 	int m_bab_nodes;
 };
@@ -0,0 +1,250 @@
+#include "mlbparcflowformulation.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <stdexcept>
+
+
+MLBPArcFlowFormulation::Graph MLBPArcFlowFormulation::buildGraph(int capacity, const std::vector<int>& sizes, const std::vector<int>& demand)
+{
+	const int W = capacity;
+
+	// item arcs between positions: type i starts at positions reached by larger items or by copies of i
+	std::vector<Arc> raw;
+	std::vector<char> reached(W + 1, 0), layer, next, added;
+	reached[0] = 1;
+	for (int i = 0; i < (int)sizes.size(); i++) {
+		const int v = sizes[i];
+		if (v > W)
+			continue;
+		layer = reached;
+		added.assign(W + 1, 0);
+		for (int copy = 0; copy < demand[i]; copy++) {
+			next.assign(W + 1, 0);
+			bool any = false;
+			for (int u = 0; u + v <= W; u++)
+				if (layer[u] && !added[u]) {
+					added[u] = 1;
+					raw.push_back(Arc{u, u + v, i});
+					next[u + v] = 1;
+					any = true;
+				}
+			if (!any)
+				break;
+			layer.swap(next);
+			for (int u = 0; u <= W; u++)
+				reached[u] |= layer[u];
+		}
+	}
+
+	// compression: label each position by W - longest path to a position without item arcs
+	std::sort(raw.begin(), raw.end(), [](const Arc& a, const Arc& b) { return a.tail > b.tail; });
+	std::vector<int> longest(W + 1, 0);
+	for (const Arc& a : raw)
+		longest[a.tail] = std::max(longest[a.tail], sizes[a.type] + longest[a.head]);
+
+	Graph graph;
+	graph.capacity = W;
+	for (int u = 0; u <= W; u++)
+		if (reached[u])
+			graph.labels.push_back(W - longest[u]);
+	graph.labels.push_back(W);
+	std::sort(graph.labels.begin(), graph.labels.end());
+	graph.labels.erase(std::unique(graph.labels.begin(), graph.labels.end()), graph.labels.end());
+
+	auto node = [&](int u) { return (int)(std::lower_bound(graph.labels.begin(), graph.labels.end(), W - longest[u]) - graph.labels.begin()); };
+	for (const Arc& a : raw)
+		graph.arcs.push_back(Arc{node(a.tail), node(a.head), a.type});
+	std::sort(graph.arcs.begin(), graph.arcs.end(), [](const Arc& a, const Arc& b) {
+		return a.tail != b.tail ? a.tail < b.tail : a.head != b.head ? a.head < b.head : a.type < b.type;
+	});
+	graph.arcs.erase(std::unique(graph.arcs.begin(), graph.arcs.end(), [](const Arc& a, const Arc& b) {
+		return a.tail == b.tail && a.head == b.head && a.type == b.type;
+	}), graph.arcs.end());
+
+	for (int q = 0; q + 1 < (int)graph.labels.size(); q++)
+		graph.arcs.push_back(Arc{q, q + 1, -1});
+	return graph;
+}
+
+void MLBPArcFlowFormulation::createDecisionVariables(IloEnv env, const Instance<MLBP>& inst)
+{
+	if (inst.m != 1)
+		throw std::runtime_error("Arc-flow formulation only supports instances with one level");
+
+	// item types by decreasing size, items of size 0 are packed into any used bin
+	std::map<int, std::vector<int>, std::greater<int> > by_size;
+	for (int i : inst.B[0])
+		by_size[inst.s[0][i]].push_back(i);
+	sizes.clear();
+	items.clear();
+	for (auto& type : by_size) {
+		sizes.push_back(type.first);
+		items.push_back(type.second);
+	}
+	std::vector<int> demand;
+	for (int i = 0; i < (int)sizes.size(); i++)
+		demand.push_back(sizes[i] > 0 ? (int)items[i].size() : 0);
+
+	// bin types and one graph for each capacity
+	std::map<std::pair<int, int>, std::vector<int> > by_type;
+	for (int j : inst.B[1])
+		by_type[std::make_pair(inst.w[1][j], inst.c[1][j])].push_back(j);
+	bins.clear();
+	graphs.clear();
+	std::map<int, int> graph_of;
+	int arcs = 0;
+	for (auto& type : by_type) {
+		int capacity = type.first.first;
+		if (graph_of.find(capacity) == graph_of.end()) {
+			graph_of[capacity] = (int)graphs.size();
+			graphs.push_back(buildGraph(capacity, sizes, demand));
+			arcs += (int)graphs.back().arcs.size();
+		}
+		graphs[graph_of[capacity]].bin_types.push_back((int)bins.size());
+		bins.push_back(type.second);
+	}
+
+	// decision variables f_{ga}
+	f = IloArray<IloNumVarArray>(env, graphs.size());
+	for (int g = 0; g < (int)graphs.size(); g++) {
+		int available = 0;
+		for (int t : graphs[g].bin_types)
+			available += (int)bins[t].size();
+		f[g] = IloNumVarArray(env, graphs[g].arcs.size(), 0, available, ILOINT);
+	}
+	MIP_OUT(TRACE) << "created " << arcs << " f_{ga} variables for " << graphs.size() << " capacities" << std::endl;
+
+	// decision variables z_t
+	z = IloNumVarArray(env, bins.size());
+	for (int t = 0; t < (int)bins.size(); t++)
+		z[t] = IloNumVar(env, 0, bins[t].size(), ILOINT);
+	MIP_OUT(TRACE) << "created " << bins.size() << " z_t variables" << std::endl;
+}
+
+void MLBPArcFlowFormulation::addConstraints(IloEnv env, IloModel model, const Instance<MLBP>& inst)
+{
+	// flow conservation: the flow from the source to the target equals the number of used bins of the capacity
+	int count = 0;
+	for (int g = 0; g < (int)graphs.size(); g++) {
+		const Graph& graph = graphs[g];
+		const int nodes = (int)graph.labels.size();
+		std::vector<IloExpr> balance;
+		for (int q = 0; q < nodes; q++)
+			balance.push_back(IloExpr(env));
+		for (int a = 0; a < (int)graph.arcs.size(); a++) {
+			balance[graph.arcs[a].tail] += f[g][a];
+			balance[graph.arcs[a].head] -= f[g][a];
+		}
+		for (int t : graph.bin_types) {
+			balance[0] -= z[t];
+			if (nodes > 1)
+				balance[nodes - 1] += z[t];
+		}
+		for (int q = 0; q < nodes; q++) {
+			model.add(balance[q] == 0);
+			balance[q].end();
+		}
+		count += nodes;
+	}
+	MIP_OUT(TRACE) << "added " << count << " flow conservation constraints" << std::endl;
+
+	// each item type must be packed at least d_i times
+	for (int i = 0; i < (int)sizes.size(); i++) {
+		IloExpr sum(env);
+		for (int g = 0; g < (int)graphs.size(); g++)
+			for (int a = 0; a < (int)graphs[g].arcs.size(); a++)
+				if (graphs[g].arcs[a].type == i)
+					sum += f[g][a];
+		model.add(sum >= (sizes[i] > 0 ? (int)items[i].size() : 0));
+		sum.end();
+	}
+	MIP_OUT(TRACE) << "added " << sizes.size() << " demand constraints" << std::endl;
+
+	// items of size 0 need a used bin
+	if (!sizes.empty() && sizes.back() == 0) {
+		IloExpr sum(env);
+		for (int t = 0; t < (int)bins.size(); t++)
+			sum += z[t];
+		model.add(sum >= 1);
+		sum.end();
+	}
+}
+
+void MLBPArcFlowFormulation::addObjectiveFunction(IloEnv env, IloModel model, const Instance<MLBP>& inst)
+{
+	IloExpr sum(env);
+	for (int t = 0; t < (int)bins.size(); t++)
+		sum += z[t] * inst.c[1][bins[t][0]];
+	model.add(IloMinimize(env, sum));
+	sum.end();
+}
+
+void MLBPArcFlowFormulation::extractSolution(IloCplex cplex, const Instance<MLBP>& inst, Solution<MLBP>& sol)
+{
+	sol.item_to_bins[0].assign(inst.n[0], -1);
+	sol.total_cost = 0;
+	sol.total_bins = 0;
+
+	// decompose the flow of each graph into source-target paths, one path per used bin
+	std::vector<int> packed(sizes.size(), 0);
+	int any_bin = -1;
+	for (int g = 0; g < (int)graphs.size(); g++) {
+		const Graph& graph = graphs[g];
+		const int nodes = (int)graph.labels.size();
+		std::vector<int> flow(graph.arcs.size());
+		std::vector<std::vector<int> > out(nodes);
+		for (int a = 0; a < (int)graph.arcs.size(); a++) {
+			flow[a] = (int)std::lround(cplex.getValue(f[g][a]));
+			out[graph.arcs[a].tail].push_back(a);
+		}
+
+		for (int t : graph.bin_types) {
+			int used = (int)std::lround(cplex.getValue(z[t]));
+			for (int b = 0; b < used; b++) {
+				const int j = bins[t][b];
+				bool empty = true;
+				for (int q = 0; q != nodes - 1; ) {
+					int a = -1;
+					for (int cand : out[q])
+						if (flow[cand] > 0) {
+							a = cand;
+							break;
+						}
+					if (a < 0)
+						break;
+					flow[a]--;
+					int type = graph.arcs[a].type;
+					if (type >= 0 && packed[type] < (int)items[type].size()) {
+						sol.item_to_bins[0][items[type][packed[type]++]] = j;
+						empty = false;
+					}
+					q = graph.arcs[a].head;
+				}
+				if (empty)
+					continue;  // surplus copies only
+				sol.total_cost += inst.c[1][j];
+				sol.total_bins++;
+				any_bin = j;
+			}
+		}
+	}
+
+	if (!sizes.empty() && sizes.back() == 0) {
+		if (any_bin < 0) {
+			any_bin = bins[std::min_element(bins.begin(), bins.end(), [&](const std::vector<int>& a, const std::vector<int>& b) {
+				return inst.c[1][a[0]] < inst.c[1][b[0]];
+			}) - bins.begin()][0];
+			sol.total_cost += inst.c[1][any_bin];
+			sol.total_bins++;
+		}
+		for (int i : items.back())
+			sol.item_to_bins[0][i] = any_bin;
+	}
+}
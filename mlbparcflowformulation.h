@@ -0,0 +1,80 @@
+#ifndef __MLBP_ARC_FLOW_FORMULATION_H__
+#define __MLBP_ARC_FLOW_FORMULATION_H__
+
+#include <vector>
+
+#include "problems.h"
+#include "mipsolver.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Arc-flow formulation for the Multi-Level Bin Packing Problem with a single level (m = 1),
+ * i.e. the variable-sized bin packing problem with costs.
+ * Items of equal size form an item type, bins of equal capacity and cost form a bin type.
+ * For each capacity W, the packing patterns are the paths of a graph with nodes 0...W:
+ *
+ *  *) item arcs -> (u, u + s_i) for an item type i; item types are added by decreasing size and
+ *                  only from nodes reached by larger items or at most d_i - 1 copies of i (symmetry reduction)
+ *  *) loss arcs -> between consecutive nodes up to the target W
+ *  *) compression -> each node u is relabelled to W - (longest path from u to a node without item arcs),
+ *                    nodes with equal labels are merged
+ *
+ *  Uses two kinds of integer decision variables:
+ *
+ *  *) f_{ga} -> flow on arc a of the graph g
+ *  *) z_t    -> number of used bins of type t (flow from the source of the graph of its capacity)
+ *
+ *  The solution is obtained by decomposing the flow into paths, each path is one bin.
+ *  Only supports instances with m = 1.
+ */
+class MLBPArcFlowFormulation : public MIPFormulation<MLBP>
+{
+public:
+	// create all required decision variables
+	virtual void createDecisionVariables(IloEnv env, const Instance<MLBP>& inst) override;
+
+	// add all constraints to the model
+	virtual void addConstraints(IloEnv env, IloModel model, const Instance<MLBP>& inst) override;
+
+	// add objective function to the model
+	virtual void addObjectiveFunction(IloEnv env, IloModel model, const Instance<MLBP>& inst) override;
+
+	// derive solution from the cplex object
+	virtual void extractSolution(IloCplex cplex, const Instance<MLBP>& inst, Solution<MLBP>& sol) override;
+
+private:
+	struct Arc
+	{
+		int tail;  // index of the tail node
+		int head;  // index of the head node
+		int type;  // item type, -1: loss arc
+	};
+
+	// compressed graph of one capacity, the nodes are sorted by label (first: source, last: target)
+	struct Graph
+	{
+		int capacity;
+		std::vector<int> labels;
+		std::vector<Arc> arcs;
+		std::vector<int> bin_types;  // bin types of this capacity
+	};
+
+	// builds the compressed graph of the given capacity for item types of decreasing sizes with the given demands
+	static Graph buildGraph(int capacity, const std::vector<int>& sizes, const std::vector<int>& demand);
+
+	std::vector<int> sizes;                      // size of each item type (decreasing)
+	std::vector<std::vector<int> > items;        // items of each item type
+	std::vector<std::vector<int> > bins;         // bins of level 1 of each bin type
+	std::vector<Graph> graphs;
+
+	// integer decision variables f_{ga}: flow on arc a of graph g
+	IloArray<IloNumVarArray> f;
+
+	// integer decision variables z_t: number of used bins of type t
+	IloNumVarArray z;
+};
+
+
+#endif // __MLBP_ARC_FLOW_FORMULATION_H__
@@ -129,3 +129,23 @@ void MLBPFormulation::extractSolution(IloCplex cplex, const Instance<MLBP>& inst
 	}
 }
 
+int MLBPFormulation::stages(const Instance<MLBP>& inst) const
+{
+	return inst.m;
+}
+
+void MLBPFormulation::addStageVariables(IloNumVarArray vars, const Instance<MLBP>& inst, int stage)
+{
+	// stage k decides the packing of the items/bins of level k into the bins of level k + 1
+	for (int i : inst.B[stage])
+		vars.add(x[stage][i]);
+	vars.add(y[stage + 1]);
+	if (stage == 0)
+		vars.add(y[0]);
+}
+
+bool MLBPFormulation::fixSolution(IloModel model, const Instance<MLBP>& inst, const Solution<MLBP>& sol, const std::vector<std::vector<char> >& free)
+{
+	fixAssignment(x, inst, sol, free);
+	return true;
+}
@@ -15,6 +15,9 @@ public:
 	virtual void addConstraints(IloEnv env, IloModel model, const Instance<MLBP>& inst);
 	virtual void addObjectiveFunction(IloEnv env, IloModel model, const Instance<MLBP>& inst);
 	virtual void extractSolution(IloCplex cplex, const Instance<MLBP>& inst, Solution<MLBP>& sol);
+	virtual int stages(const Instance<MLBP>& inst) const;
+	virtual void addStageVariables(IloNumVarArray vars, const Instance<MLBP>& inst, int stage);
+	virtual bool fixSolution(IloModel model, const Instance<MLBP>& inst, const Solution<MLBP>& sol, const std::vector<std::vector<char> >& free);
 private:
 
 	// binary decision variables x_{kij}: item/bin of index i of level k is inserted into bin j of level k + 1 (=1) or not (=0)
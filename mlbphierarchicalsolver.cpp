@@ -0,0 +1,258 @@
+#include "mlbphierarchicalsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "mipsolver.h"
+#include "bpformulation.h"
+#include "mlbparcflowformulation.h"
+#include "bpsolver.h"
+#include "branchandboundsolver.h"
+#include "fitdecreasingsolver.h"
+#include "users.h"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+// batches with more elements are not given to the native exact solvers (and the assignment-based BPFormulation)
+static const int MAX_EXACT = 500;
+
+MLBPHierarchicalSolver::Status MLBPHierarchicalSolver::run(const Instance<MLBP>& inst, Solution<MLBP>& sol)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto expired = [&]() {
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+		return d.count() >= m_time_limit;
+	};
+
+	const int m = inst.m;
+	for (int k = 0; k < m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+
+	// cost per capacity of carrying one unit of size from level k to the top
+	const double inf = std::numeric_limits<double>::infinity();
+	std::vector<double> rate(m + 2, 0.0);
+	m_cost.assign(m + 1, std::vector<int>());
+	for (int k = m; k >= 1; k--) {
+		rate[k] = inf;
+		m_cost[k].resize(inst.n[k]);
+		for (int j : inst.B[k]) {
+			double cost = inst.c[k][j] + (rate[k + 1] < inf ? inst.s[k][j] * rate[k + 1] : 0);
+			m_cost[k][j] = (int)std::lround(cost);
+			rate[k] = std::min(rate[k], cost / std::max(1, inst.w[k][j]));
+		}
+	}
+
+	// unused bins are offered to a batch by increasing cost per capacity and by decreasing capacity
+	m_order.assign(m + 1, std::vector<std::vector<int> >());
+	m_first.assign(m + 1, std::vector<size_t>(2, 0));
+	for (int k : inst.M) {
+		m_order[k].assign(2, inst.B[k]);
+		std::stable_sort(m_order[k][0].begin(), m_order[k][0].end(), [&](int a, int b) { return (double)m_cost[k][a] / std::max(1, inst.w[k][a]) < (double)m_cost[k][b] / std::max(1, inst.w[k][b]); });
+		std::stable_sort(m_order[k][1].begin(), m_order[k][1].end(), [&](int a, int b) { return inst.w[k][a] > inst.w[k][b]; });
+	}
+
+	// items by decreasing size, dealt round-robin to the batches of level 1
+	std::vector<int> order(inst.B[0]);
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return inst.s[0][a] > inst.s[0][b]; });
+	const int size = m_batch > 0 ? m_batch : INT_MAX;
+	const int count = m_batch > 0 ? std::max(1, (inst.n[0] + m_batch - 1) / m_batch) : 1;
+	const int time = std::max(1, m_time_limit / (m * count));
+
+	// stage k: elements of level k - 1 waiting for the bins of level k
+	struct Stage
+	{
+		std::mutex mutex;
+		std::condition_variable ready;
+		std::vector<int> queue;
+		size_t next = 0;
+		bool done = false;
+	};
+	std::vector<Stage> stages(m + 1);
+	for (int t = 0; t < count; t++)
+		for (int q = t; q < inst.n[0]; q += count)
+			stages[1].queue.push_back(order[q]);
+	stages[1].done = true;
+
+	std::atomic<bool> failed(false);
+	std::atomic<int> batches(0);
+	auto level = [&](int k) {
+		std::vector<char> unused(inst.n[k], 1);
+		for (;;) {
+			std::vector<int> items;
+			{
+				std::unique_lock<std::mutex> lock(stages[k].mutex);
+				stages[k].ready.wait(lock, [&]() { return failed || stages[k].done || stages[k].queue.size() - stages[k].next >= (size_t)size; });
+				size_t end = stages[k].next + std::min(stages[k].queue.size() - stages[k].next, (size_t)size);
+				items.assign(stages[k].queue.begin() + stages[k].next, stages[k].queue.begin() + end);
+				stages[k].next = end;
+			}
+			if (items.empty() || failed)
+				break;
+
+			std::vector<int> used;
+			if (!pack(inst, k, items, expired() ? 0 : time, unused, sol, used)) {
+				HEU_OUT(WARN) << "level " << k << ": " << items.size() << " elements do not fit into the unused bins" << std::endl;
+				failed = true;
+				break;
+			}
+			batches++;
+			HEU_OUT(DBG) << "level " << k << ": " << items.size() << " elements packed into " << used.size() << " bins" << std::endl;
+
+			if (k < m) {
+				// the bins of the batch are closed, the next level may pack them
+				std::lock_guard<std::mutex> lock(stages[k + 1].mutex);
+				stages[k + 1].queue.insert(stages[k + 1].queue.end(), used.begin(), used.end());
+				stages[k + 1].ready.notify_one();
+			}
+		}
+		if (k < m) {
+			std::lock_guard<std::mutex> lock(stages[k + 1].mutex);
+			stages[k + 1].done = true;
+			stages[k + 1].ready.notify_one();
+		}
+	};
+
+	if (m_batch > 0) {
+		std::vector<std::thread> threads;
+		for (int k = 2; k <= m; k++)
+			threads.emplace_back(level, k);
+		level(1);
+		for (auto& thread : threads)
+			thread.join();
+	} else {
+		for (int k : inst.M)
+			level(k);
+	}
+	m_batches = batches;
+	if (failed)
+		return Aborted;
+
+	sol.total_cost = 0;
+	sol.total_bins = 0;
+	for (int k : inst.M) {
+		std::vector<char> used(inst.n[k], 0);
+		for (int b : sol.item_to_bins[k - 1])
+			if (b >= 0 && !used[b]) {
+				used[b] = 1;
+				sol.total_cost += inst.c[k][b];
+				sol.total_bins++;
+			}
+	}
+	HEU_OUT(INFO) << "hierarchical: " << m_batches << " batches, " << sol.total_bins << " bins, cost " << sol.total_cost << std::endl;
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+bool MLBPHierarchicalSolver::pack(const Instance<MLBP>& inst, int k, const std::vector<int>& items, int time, std::vector<char>& unused,
+                                  Solution<MLBP>& sol, std::vector<int>& used)
+{
+	// at most one bin per element from each order: enough to pack the batch alone and to fit its largest element
+	std::vector<int> bins;
+	for (int o = 0; o < 2; o++) {
+		const std::vector<int>& order = m_order[k][o];
+		size_t& first = m_first[k][o];
+		while (first < order.size() && !unused[order[first]])
+			first++;
+		for (size_t q = first, taken = 0; q < order.size() && taken < items.size(); q++)
+			if (unused[order[q]] == 1) {
+				unused[order[q]] = 2;
+				bins.push_back(order[q]);
+				taken++;
+			}
+	}
+	for (int j : bins)
+		unused[j] = 1;
+	if (bins.empty())
+		return false;
+	std::sort(bins.begin(), bins.end());
+	std::vector<int> assign(items.size(), -1);  // index into bins
+	bool solved = false;
+
+	bool identical = true;
+	for (int j : bins)
+		identical = identical && std::make_tuple(inst.w[k][j], inst.c[k][j], inst.s[k][j]) == std::make_tuple(inst.w[k][bins[0]], inst.c[k][bins[0]], inst.s[k][bins[0]]);
+	if (identical && time > 0 && (int)items.size() <= MAX_EXACT) {
+		// bin packing problem, enough bins if the number of used bins does not exceed the unused bins
+		std::vector<int> sizes;
+		for (int x : items)
+			sizes.push_back(inst.s[k - 1][x]);
+		Instance<BP> bp(sizes, inst.w[k][bins[0]]);
+		Solution<BP> bp_sol(bp);
+		Status status = Aborted;
+		try {
+			if (m_mode == MIP) {
+				MIPSolver<BP> mip_solver;
+				mip_solver.setTimeLimit(time);
+				mip_solver.setThreads(m_threads);
+				mip_solver.setFormulation<BPFormulation>();
+				status = mip_solver.run(bp, bp_sol);
+			} else {
+				BPSolver bp_solver;
+				bp_solver.setTimeLimit(time);
+				status = bp_solver.run(bp, bp_sol);
+			}
+		} catch (const std::exception& exp) {
+			HEU_OUT(WARN) << "level " << k << ": " << exp.what() << std::endl;
+		}
+		if ((status == Optimal || status == Feasible) && SolutionVerifier<BP>::verify(bp, bp_sol)) {
+			std::vector<int> index(items.size(), -1);
+			int number = 0;
+			for (int t = 0; t < (int)items.size(); t++) {
+				int& b = index.at(bp_sol.item_to_bins[t]);
+				if (b < 0)
+					b = number++;
+				assign[t] = b;
+			}
+			solved = number <= (int)bins.size();
+		}
+	}
+
+	if (!solved) {
+		// variable-sized bin packing problem with costs, the bins pay for carrying their size further up
+		Instance<MLBP> sub(inst, k, items, bins);
+		for (int q = 0; q < sub.n[1]; q++)
+			sub.c[1][q] = m_cost[k][bins[q]];
+		Solution<MLBP> sub_sol(sub);
+		Status status = Aborted;
+		if (time > 0 && (m_mode == MIP || (int)items.size() <= MAX_EXACT)) {
+			try {
+				if (m_mode == MIP) {
+					MIPSolver<MLBP> mip_solver;
+					mip_solver.setTimeLimit(time);
+					mip_solver.setThreads(m_threads);
+					mip_solver.setFormulation<MLBPArcFlowFormulation>();
+					status = mip_solver.run(sub, sub_sol);
+				} else {
+					BranchAndBoundSolver<MLBP> bb_solver;
+					bb_solver.setTimeLimit(time);
+					status = bb_solver.run(sub, sub_sol);
+				}
+			} catch (const std::exception& exp) {
+				HEU_OUT(WARN) << "level " << k << ": " << exp.what() << std::endl;
+			}
+		}
+		if (!((status == Optimal || status == Feasible) && SolutionVerifier<MLBP>::verify(sub, sub_sol))) {
+			sub_sol = Solution<MLBP>(sub);
+			if (FitDecreasingSolver<MLBP>().run(sub, sub_sol) != Feasible)
+				return false;
+		}
+		assign = sub_sol.item_to_bins[0];
+	}
+
+	for (int t = 0; t < (int)items.size(); t++) {
+		int j = bins[assign[t]];
+		sol.item_to_bins[k - 1][items[t]] = j;
+		if (unused[j]) {
+			unused[j] = 0;
+			used.push_back(j);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+#ifndef __MLBP_HIERARCHICAL_SOLVER_H__
+#define __MLBP_HIERARCHICAL_SOLVER_H__
+
+#include <vector>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Level-by-level heuristic for the Multi-Level Bin Packing Problem: the items are packed into bins of level 1,
+ * the used bins of level 1 are packed as items into bins of level 2 and so on. Each step is a single-level
+ * variable-sized bin packing problem with costs, solved by the bin packing machinery:
+ *
+ *  *) costs    -> a bin of level k < m costs c_kj + s_kj * r_{k+1}, r_{k+1}: cheapest cost per capacity of carrying
+ *                 one unit of size through the levels above (as in the bound of BranchAndBoundSolver)
+ *  *) solve    -> if the unused bins of the level are identical (capacity, cost, size), the step is a Bin Packing
+ *                 Problem (BPSolver or MIPSolver<BP> with BPFormulation), otherwise an MLBP instance with a single
+ *                 level (BranchAndBoundSolver or MIPSolver<MLBP> with MLBPArcFlowFormulation); FFD/BFD if these fail
+ *                 or the batch is too large for them (only the arc-flow formulation takes batches of any size)
+ *  *) batches  -> a batch is packed into at most one unused bin per element by increasing cost per capacity
+ *                 and one per element by decreasing capacity
+ *  *) pipeline -> with a batch size b > 0 each level runs in its own thread and packs its elements in batches of b
+ *                 (the items are dealt round-robin by decreasing size); the bins used by a batch are closed and
+ *                 passed on, so level k + 1 starts as soon as level k closed its first b bins. b = 0: one batch per level
+ *  *) time     -> each level gets an equal share of the time limit, split over its batches; once the time limit
+ *                 is reached, the remaining batches are packed by FFD/BFD only
+ *
+ *  Status Feasible, Aborted if the elements of a batch do not fit into the unused bins of the level.
+ */
+class MLBPHierarchicalSolver : public SolverStatus
+{
+public:
+	enum Mode
+	{
+		Native,  // BPSolver and BranchAndBoundSolver
+		MIP      // MIPSolver with BPFormulation and MLBPArcFlowFormulation
+	};
+
+	MLBPHierarchicalSolver(Mode mode = Native) : m_mode(mode), m_time_limit(10), m_threads(1), m_batch(0), m_batches(0) { }
+
+	void setTimeLimit(int time) { m_time_limit = std::max(1, time); }  // in seconds
+	void setThreads(int number) { m_threads = std::max(1, number); }   // number of threads of each MIP
+	void setBatch(int size) { m_batch = std::max(0, size); }           // elements per batch, 0: one batch per level
+
+	Status run(const Instance<MLBP>& inst, Solution<MLBP>& sol);
+
+	int batches() const { return m_batches; }  // number of solved batches over all levels from last run(...) call
+
+private:
+	// packs the elements items of level k - 1 into the unused bins of level k, appends the newly used bins to used;
+	// false if they do not fit
+	bool pack(const Instance<MLBP>& inst, int k, const std::vector<int>& items, int time, std::vector<char>& unused,
+	          Solution<MLBP>& sol, std::vector<int>& used);
+
+	Mode m_mode;
+	int m_time_limit;
+	int m_threads;
+	int m_batch;
+	int m_batches;
+
+	std::vector<std::vector<int> > m_cost;                 // m_cost[k][j]: c_kj + s_kj * r_{k+1} (rounded)
+	std::vector<std::vector<std::vector<int> > > m_order;  // bins of level k by cost per capacity (0) and by capacity (1)
+	std::vector<std::vector<size_t> > m_first;             // first position of each order which may be unused
+};
+
+#endif // __MLBP_HIERARCHICAL_SOLVER_H__
@@ -204,3 +204,25 @@ void MLBPNFFormulation::extractSolution(IloCplex cplex, const Instance<MLBP>& in
 	}
 }
 
+int MLBPNFFormulation::stages(const Instance<MLBP>& inst) const
+{
+	return inst.m;
+}
+
+void MLBPNFFormulation::addStageVariables(IloNumVarArray vars, const Instance<MLBP>& inst, int stage)
+{
+	// stage k decides the packing of the items/bins of level k into the bins of level k + 1
+	for (int i : inst.B[stage])
+		vars.add(x[stage][i]);
+	for (int i : inst.B[stage])
+		vars.add(f[stage][i]);
+	vars.add(y[stage + 1]);
+	if (stage == 0)
+		vars.add(y[0]);
+}
+
+bool MLBPNFFormulation::fixSolution(IloModel model, const Instance<MLBP>& inst, const Solution<MLBP>& sol, const std::vector<std::vector<char> >& free)
+{
+	fixAssignment(x, inst, sol, free);
+	return true;
+}
@@ -0,0 +1,506 @@
+#include "mlbptwcgsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "knapsack.h"
+#include "users.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+ILOSTLBEGIN
+
+static const double EPS = 1e-6;
+
+
+MLBPTWCGSolver::MLBPTWCGSolver() : m_time_limit(0), m_threads(0), m_lower_bound(0.0)
+{
+}
+
+MLBPTWCGSolver::~MLBPTWCGSolver()
+{
+	cplex.end();
+	model.end();
+	env.end();
+}
+
+double MLBPTWCGSolver::remainingTime() const
+{
+	if (m_time_limit == 0)
+		return std::numeric_limits<double>::infinity();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+	return std::max(0.0, m_time_limit - elapsed.count());
+}
+
+MLBPTWCGSolver::Status MLBPTWCGSolver::run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol)
+{
+	m_start = std::chrono::steady_clock::now();
+	m_patterns.clear();
+	m_signatures.clear();
+	m_lower_bound = 0.0;
+
+	// candidate start times are the distinct earliest starting times
+	std::vector<int> times(inst.e);
+	std::sort(times.begin(), times.end());
+	times.erase(std::unique(times.begin(), times.end()), times.end());
+
+	try {
+		env = IloEnv();
+		model = IloModel(env);
+		buildMaster(inst);
+		MIP_OUT(DBG) << "created restricted master problem" << std::endl;
+
+		cplex = IloCplex(model);
+		if (m_threads != 0)
+			cplex.setParam(IloCplex::Param::Threads, m_threads);
+#ifndef USER_MIP
+		cplex.setOut(env.getNullStream());
+		cplex.setWarning(env.getNullStream());
+		cplex.setError(env.getNullStream());
+#endif
+
+		/************************************************************************/
+		/** Column generation **************************************************/
+		/************************************************************************/
+		int iteration = 0;
+		while (remainingTime() > 0) {
+			if (m_time_limit != 0)
+				cplex.setParam(IloCplex::Param::TimeLimit, remainingTime());
+			if (!cplex.solve() || cplex.getStatus() != IloAlgorithm::Optimal)
+				break;
+
+			double z = cplex.getObjValue();
+			updateDuals(inst);
+
+			int added = 0;
+			Pattern pat;
+			for (int top : inst.B[inst.m]) {
+				for (int t : times) {
+					if (priceHeuristic(inst, top, t, pat) && addColumn(inst, pat))
+						added++;
+				}
+			}
+			MIP_OUT(DBG) << "iteration " << iteration << ": z_RMP=" << z << ", added " << added << " columns (heuristic pricing)" << std::endl;
+			iteration++;
+			if (added > 0)
+				continue;
+
+			// heuristic pricing failed -> exact pricing, which also provides the Lagrangian bound
+			// the bound is only valid if all pricing problems were solved to optimality
+			double lb = z;
+			bool priced = true, optimal = true, solved;
+			for (int top : inst.B[inst.m]) {
+				double rc_top = 0.0;
+				for (int t : times) {
+					if (remainingTime() <= 0) {
+						priced = false;
+						break;
+					}
+					double rc = priceExact(inst, top, t, pat, solved);
+					optimal = optimal && solved;
+					rc_top = std::min(rc_top, rc);
+					if (!pat.assign.empty() && reducedCost(inst, pat) < -EPS && addColumn(inst, pat))
+						added++;
+				}
+				if (!priced)
+					break;
+				lb += rc_top;
+			}
+			if (!priced || !optimal) {
+				// a pricing problem was skipped or hit the time limit: neither lb nor z is a valid bound
+				if (priced && added > 0)
+					continue;
+				MIP_OUT(DBG) << "iteration " << iteration << ": exact pricing not solved to optimality, added " << added << " columns" << std::endl;
+				break;
+			}
+			m_lower_bound = std::max(m_lower_bound, lb);
+			MIP_OUT(DBG) << "iteration " << iteration << ": lower bound=" << lb << ", added " << added << " columns (exact pricing)" << std::endl;
+
+			if (added == 0) {
+				m_lower_bound = std::max(m_lower_bound, z);  // LP relaxation solved to optimality
+				break;
+			}
+		}
+		MIP_OUT(DBG) << "column generation finished with " << m_patterns.size() << " columns, lower bound: " << m_lower_bound << std::endl;
+
+		/************************************************************************/
+		/** Price-and-branch: solve restricted master problem as MIP ***********/
+		/************************************************************************/
+		model.add(IloConversion(env, lambda, ILOBOOL));
+		for (int i : inst.B[0])
+			art[i].setUB(0);
+
+		if (m_time_limit != 0)
+			cplex.setParam(IloCplex::Param::TimeLimit, std::max(1.0, remainingTime()));
+		cplex.solve();
+
+		IloAlgorithm::Status stat = cplex.getStatus();
+		MIP_OUT(DBG) << "CPLEX status of restricted master MIP: " << stat << std::endl;
+		if (stat != IloAlgorithm::Optimal && stat != IloAlgorithm::Feasible) {
+			MIP_OUT(FATAL) << "No feasible solution found by the restricted master problem" << std::endl;
+			return Aborted;
+		}
+
+		extractSolution(inst, sol);
+		sol.db = (int)std::ceil(m_lower_bound - EPS);
+		MIP_OUT(DBG) << "Objective value: " << sol.total_cost << std::endl;
+		MIP_OUT(DBG) << "Lower Bound: " << sol.db << std::endl;
+
+		return sol.total_cost <= sol.db ? Optimal : Feasible;
+
+	} catch(IloException& e) {
+		throw std::runtime_error(e.getMessage());
+	}
+}
+
+void MLBPTWCGSolver::buildMaster(const Instance<MLBPTW>& inst)
+{
+	obj = IloMinimize(env);
+	model.add(obj);
+
+	item_rows = IloRangeArray(env, inst.n[0]);
+	for (int i : inst.B[0])
+		item_rows[i] = IloRange(env, 1, 1);
+	model.add(item_rows);
+
+	bin_rows = IloArray<IloRangeArray>(env, inst.m + 1);
+	for (int k : inst.M) {
+		bin_rows[k] = IloRangeArray(env, inst.n[k]);
+		for (int j : inst.B[k])
+			bin_rows[k][j] = IloRange(env, -IloInfinity, 1);
+		model.add(bin_rows[k]);
+	}
+
+	// artificial variables are more expensive than any feasible solution
+	double big_m = 1.0;
+	for (int k : inst.M)
+		big_m += std::accumulate(inst.c[k].begin(), inst.c[k].end(), 0.0);
+	for (int i : inst.B[0])
+		big_m += (double)inst.p * (inst.l[i] - inst.e[i]);
+
+	art = IloNumVarArray(env, inst.n[0], 0, IloInfinity);
+	for (int i : inst.B[0]) {
+		obj.setLinearCoef(art[i], big_m);
+		item_rows[i].setLinearCoef(art[i], 1);
+	}
+
+	lambda = IloNumVarArray(env);
+	pi.assign(inst.n[0], 0.0);
+	mu.assign(inst.m + 1, std::vector<double>());
+	for (int k : inst.M)
+		mu[k].assign(inst.n[k], 0.0);
+}
+
+bool MLBPTWCGSolver::addColumn(const Instance<MLBPTW>& inst, const Pattern& pat)
+{
+	// signature: top, start time and all assignments
+	std::vector<int> sig{pat.top, pat.t};
+	for (const auto& lvl : pat.assign) {
+		std::vector<std::pair<int, int> > sorted(lvl);
+		std::sort(sorted.begin(), sorted.end());
+		for (const auto& a : sorted) {
+			sig.push_back(a.first);
+			sig.push_back(a.second);
+		}
+		sig.push_back(-1);
+	}
+	if (!m_signatures.insert(sig).second)
+		return false;
+
+	IloNumVar var(env, 0, IloInfinity);
+	obj.setLinearCoef(var, pat.cost);
+	for (const auto& a : pat.assign[0])
+		item_rows[a.first].setLinearCoef(var, 1);
+	for (int k = 0; k < inst.m; k++)
+		for (const auto& a : pat.assign[k])
+			if (k > 0)
+				bin_rows[k][a.first].setLinearCoef(var, 1);
+	bin_rows[inst.m][pat.top].setLinearCoef(var, 1);
+
+	lambda.add(var);
+	m_patterns.push_back(pat);
+	return true;
+}
+
+void MLBPTWCGSolver::updateDuals(const Instance<MLBPTW>& inst)
+{
+	for (int i : inst.B[0])
+		pi[i] = cplex.getDual(item_rows[i]);
+	for (int k : inst.M)
+		for (int j : inst.B[k])
+			mu[k][j] = std::min(0.0, (double)cplex.getDual(bin_rows[k][j]));
+}
+
+void MLBPTWCGSolver::finalizePattern(const Instance<MLBPTW>& inst, Pattern& pat) const
+{
+	// remove bins without content (bottom-up)
+	for (int k = 1; k < inst.m; k++) {
+		std::vector<char> filled(inst.n[k], 0);
+		for (const auto& a : pat.assign[k - 1])
+			filled[a.second] = 1;
+		auto& lvl = pat.assign[k];
+		lvl.erase(std::remove_if(lvl.begin(), lvl.end(), [&](const std::pair<int, int>& a) { return !filled[a.first]; }), lvl.end());
+	}
+
+	pat.cost = inst.c[inst.m][pat.top];
+	for (int k = 1; k < inst.m; k++)
+		for (const auto& a : pat.assign[k])
+			pat.cost += inst.c[k][a.first];
+	for (const auto& a : pat.assign[0])
+		pat.cost += inst.p * (pat.t - inst.e[a.first]);
+}
+
+double MLBPTWCGSolver::reducedCost(const Instance<MLBPTW>& inst, const Pattern& pat) const
+{
+	double rc = pat.cost - mu[inst.m][pat.top];
+	for (const auto& a : pat.assign[0])
+		rc -= pi[a.first];
+	for (int k = 1; k < inst.m; k++)
+		for (const auto& a : pat.assign[k])
+			rc -= mu[k][a.first];
+	return rc;
+}
+
+bool MLBPTWCGSolver::priceHeuristic(const Instance<MLBPTW>& inst, int top, int t, Pattern& pat) const
+{
+	pat.top = top;
+	pat.t = t;
+	pat.assign.assign(inst.m, std::vector<std::pair<int, int> >());
+
+	// elements of the current level: items which can start at t with positive profit
+	std::vector<int> idx;
+	std::vector<int> size;
+	std::vector<double> value;
+	for (int i : inst.B[0]) {
+		double v = pi[i] - inst.p * (t - inst.e[i]);
+		if (inst.e[i] <= t && t <= inst.l[i] && v > EPS) {
+			idx.push_back(i);
+			size.push_back(inst.s[0][i]);
+			value.push_back(v);
+		}
+	}
+
+	std::vector<int> sel;
+	std::vector<int> cand_size;
+	std::vector<double> cand_value;
+	std::vector<int> cand_pos;
+
+	// fill the bins of level k one after another, cheapest net cost per capacity first
+	for (int k = 1; k < inst.m && !idx.empty(); k++) {
+		std::vector<int> order(inst.B[k]);
+		std::sort(order.begin(), order.end(), [&](int a, int b) {
+			return (inst.c[k][a] - mu[k][a]) * inst.w[k][b] < (inst.c[k][b] - mu[k][b]) * inst.w[k][a];
+		});
+
+		std::vector<char> packed(idx.size(), 0);
+		std::vector<int> next_idx;
+		std::vector<int> next_size;
+		std::vector<double> next_value;
+		for (int j : order) {
+			cand_size.clear();
+			cand_value.clear();
+			cand_pos.clear();
+			for (int q = 0; q < (int)idx.size(); q++) {
+				if (!packed[q]) {
+					cand_pos.push_back(q);
+					cand_size.push_back(size[q]);
+					cand_value.push_back(value[q]);
+				}
+			}
+			if (cand_pos.empty())
+				break;
+
+			double gain = knapsack01(cand_size, cand_value, inst.w[k][j], sel) - (inst.c[k][j] - mu[k][j]);
+			if (gain <= EPS)
+				continue;
+
+			for (int q : sel) {
+				packed[cand_pos[q]] = 1;
+				pat.assign[k - 1].emplace_back(idx[cand_pos[q]], j);
+			}
+			next_idx.push_back(j);
+			next_size.push_back(inst.s[k][j]);
+			next_value.push_back(gain);
+		}
+		idx.swap(next_idx);
+		size.swap(next_size);
+		value.swap(next_value);
+	}
+	if (idx.empty())
+		return false;
+
+	// top-level bin
+	double gain = knapsack01(size, value, inst.w[inst.m][top], sel) - (inst.c[inst.m][top] - mu[inst.m][top]);
+	if (gain <= EPS)
+		return false;
+
+	// keep only the subtrees below the selected elements (top-down)
+	std::vector<char> keep(inst.n[inst.m - 1], 0);
+	for (int q : sel) {
+		keep[idx[q]] = 1;
+		pat.assign[inst.m - 1].emplace_back(idx[q], top);
+	}
+	for (int k = inst.m - 2; k >= 0; k--) {
+		std::vector<char> keep_lower(inst.n[k], 0);
+		auto& lvl = pat.assign[k];
+		lvl.erase(std::remove_if(lvl.begin(), lvl.end(), [&](const std::pair<int, int>& a) { return !keep[a.second]; }), lvl.end());
+		for (const auto& a : lvl)
+			keep_lower[a.first] = 1;
+		keep.swap(keep_lower);
+	}
+
+	finalizePattern(inst, pat);
+	return reducedCost(inst, pat) < -EPS;
+}
+
+double MLBPTWCGSolver::priceExact(const Instance<MLBPTW>& inst, int top, int t, Pattern& pat, bool& optimal)
+{
+	pat.assign.clear();
+	optimal = true;
+
+	// items which can start at t with positive profit, all other items can be omitted
+	std::vector<int> items;
+	for (int i : inst.B[0])
+		if (inst.e[i] <= t && t <= inst.l[i] && pi[i] - inst.p * (t - inst.e[i]) > EPS)
+			items.push_back(i);
+	if (items.empty())
+		return 0.0;  // the empty pattern is the best one
+
+	// elements of each level: items at level 0, all bins at level 1...m-1 and the single top-level bin at level m
+	std::vector<std::vector<int> > E(inst.m + 1);
+	E[0] = items;
+	for (int k = 1; k < inst.m; k++)
+		E[k] = inst.B[k];
+	E[inst.m] = {top};
+
+	IloModel pmodel(env);
+	IloCplex pcplex(pmodel);
+
+	// binary decision variables a_{kij}: element i of level k is inserted into element j of level k + 1
+	IloArray<IloArray<IloNumVarArray> > a(env, inst.m);
+	for (int k = 0; k < inst.m; k++) {
+		a[k] = IloArray<IloNumVarArray>(env, E[k].size());
+		for (int i = 0; i < (int)E[k].size(); i++)
+			a[k][i] = IloNumVarArray(env, E[k + 1].size(), 0, 1, ILOBOOL);
+	}
+
+	// binary decision variables y_{kj}: bin j of level k is used
+	IloArray<IloNumVarArray> y(env, inst.m);
+	for (int k = 1; k < inst.m; k++)
+		y[k] = IloNumVarArray(env, E[k].size(), 0, 1, ILOBOOL);
+
+	// each item is packed at most once, each used bin is packed exactly once
+	for (int k = 0; k < inst.m; k++) {
+		for (int i = 0; i < (int)E[k].size(); i++) {
+			IloExpr sum(env);
+			for (int j = 0; j < (int)E[k + 1].size(); j++)
+				sum += a[k][i][j];
+			if (k == 0)
+				pmodel.add(sum <= 1);
+			else
+				pmodel.add(sum == y[k][i]);
+			sum.end();
+		}
+	}
+
+	// capacities
+	for (int k = 1; k <= inst.m; k++) {
+		for (int j = 0; j < (int)E[k].size(); j++) {
+			IloExpr sum(env);
+			for (int i = 0; i < (int)E[k - 1].size(); i++)
+				sum += a[k - 1][i][j] * inst.s[k - 1][E[k - 1][i]];
+			if (k < inst.m)
+				pmodel.add(sum <= y[k][j] * inst.w[k][E[k][j]]);
+			else
+				pmodel.add(sum <= inst.w[k][top]);
+			sum.end();
+		}
+	}
+
+	// maximize profit of the items minus net cost of the bins
+	IloExpr profit(env);
+	for (int i = 0; i < (int)items.size(); i++)
+		for (int j = 0; j < (int)E[1].size(); j++)
+			profit += a[0][i][j] * (pi[items[i]] - inst.p * (t - inst.e[items[i]]));
+	for (int k = 1; k < inst.m; k++)
+		for (int j = 0; j < (int)E[k].size(); j++)
+			profit -= y[k][j] * (inst.c[k][E[k][j]] - mu[k][E[k][j]]);
+	pmodel.add(IloMaximize(env, profit));
+	profit.end();
+
+	if (m_threads != 0)
+		pcplex.setParam(IloCplex::Param::Threads, m_threads);
+	if (m_time_limit != 0)
+		pcplex.setParam(IloCplex::Param::TimeLimit, remainingTime());
+	pcplex.setOut(env.getNullStream());
+	pcplex.setWarning(env.getNullStream());
+
+	double net_top = inst.c[inst.m][top] - mu[inst.m][top];
+	double bound = -std::numeric_limits<double>::infinity();
+
+	pcplex.solve();
+	IloAlgorithm::Status stat = pcplex.getStatus();
+	optimal = stat == IloAlgorithm::Optimal;
+	if (stat == IloAlgorithm::Optimal || stat == IloAlgorithm::Feasible) {
+		bound = net_top - pcplex.getBestObjValue();
+
+		// follow the packing tree top-down
+		pat.top = top;
+		pat.t = t;
+		pat.assign.assign(inst.m, std::vector<std::pair<int, int> >());
+		std::vector<char> keep{1};
+		for (int k = inst.m - 1; k >= 0; k--) {
+			std::vector<char> keep_lower(E[k].size(), 0);
+			for (int i = 0; i < (int)E[k].size(); i++) {
+				for (int j = 0; j < (int)E[k + 1].size(); j++) {
+					if (keep[j] && pcplex.getValue(a[k][i][j]) > 0.5) {
+						keep_lower[i] = 1;
+						pat.assign[k].emplace_back(E[k][i], E[k + 1][j]);
+					}
+				}
+			}
+			keep.swap(keep_lower);
+		}
+		finalizePattern(inst, pat);
+	}
+
+	pcplex.end();
+	pmodel.end();
+	return bound;
+}
+
+void MLBPTWCGSolver::extractSolution(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol) const
+{
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+
+	sol.total_bins = 0;
+	sol.total_cost = 0;
+	for (int q = 0; q < (int)m_patterns.size(); q++) {
+		if (cplex.getValue(lambda[q]) < 0.5)
+			continue;
+
+		const Pattern& pat = m_patterns[q];
+		for (int k = 0; k < inst.m; k++)
+			for (const auto& a : pat.assign[k])
+				sol.item_to_bins[k][a.first] = a.second;
+
+		// the earliest common start time is the maximum e of the items
+		int start = std::numeric_limits<int>::min();
+		for (const auto& a : pat.assign[0])
+			start = std::max(start, inst.e[a.first]);
+
+		sol.total_bins++;
+		sol.total_cost += inst.c[inst.m][pat.top];
+		for (int k = 1; k < inst.m; k++) {
+			sol.total_bins += (int)pat.assign[k].size();
+			for (const auto& a : pat.assign[k])
+				sol.total_cost += inst.c[k][a.first];
+		}
+		for (const auto& a : pat.assign[0])
+			sol.total_cost += inst.p * (start - inst.e[a.first]);
+	}
+}
@@ -0,0 +1,103 @@
+#ifndef __MLBPTW_CG_SOLVER_H__
+#define __MLBPTW_CG_SOLVER_H__
+
+#include <ilcplex/ilocplex.h>
+
+#include <vector>
+#include <set>
+#include <chrono>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Column Generation Solver for the Multi-Level Bin Packing Problem with Time Windows.
+ * Uses a set partitioning model over top-level patterns:
+ *
+ *  *) lambda_p -> pattern p is used
+ *
+ *  A pattern is a top-level bin together with its packing tree (bins of the
+ *  levels m-1,...,1 and items) and a common start time t with e_i <= t <= l_i
+ *  for all items i of the pattern. Hence, the time windows hold implicitly and
+ *  the cost of a pattern is the cost of its bins plus p * (t - e_i) of its items.
+ *
+ *  min  sum_p c_p lambda_p
+ *  s.t. sum_p a_ip lambda_p  = 1   for each item i  (duals pi_i)
+ *       sum_p b_jp lambda_p <= 1   for each bin j   (duals mu_j <= 0)
+ *
+ *  The pricing enumerates for each top-level bin the distinct e values as start
+ *  time and packs the eligible items level by level with a knapsack per bin.
+ *  If this heuristic does not find a column with negative reduced cost, the
+ *  pricing problem is solved exactly as a MIP, which yields the Lagrangian
+ *  bound z_RMP + sum_T min(0, rc_T) as dual bound.
+ *  The integer solution is obtained by solving the final restricted master
+ *  problem as a MIP (price-and-branch).
+ */
+class MLBPTWCGSolver : public SolverStatus
+{
+public:
+	MLBPTWCGSolver();
+	~MLBPTWCGSolver();
+
+	void setTimeLimit(int time) { m_time_limit = time; }
+	void setThreads(int number) { m_threads = number;  }
+
+	Status run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol);
+
+	double lowerBound() const { return m_lower_bound; }     // Lagrangian bound from last run(...) call
+	int columns() const { return (int)m_patterns.size(); }  // number of generated columns from last run(...) call
+
+private:
+	struct Pattern
+	{
+		int top;   // top-level bin
+		int t;     // common start time of all items
+		int cost;  // bin costs plus time window penalties
+		std::vector<std::vector<std::pair<int, int> > > assign;  // assign[k]: (item/bin of level k, bin of level k+1)
+	};
+
+	void buildMaster(const Instance<MLBPTW>& inst);
+	bool addColumn(const Instance<MLBPTW>& inst, const Pattern& pat);
+	void updateDuals(const Instance<MLBPTW>& inst);
+
+	// removes bins without content and computes the cost of the pattern
+	void finalizePattern(const Instance<MLBPTW>& inst, Pattern& pat) const;
+	double reducedCost(const Instance<MLBPTW>& inst, const Pattern& pat) const;
+
+	// greedy pricing, returns true if a pattern with negative reduced cost was found
+	bool priceHeuristic(const Instance<MLBPTW>& inst, int top, int t, Pattern& pat) const;
+
+	// exact pricing, returns a lower bound on the reduced cost of all patterns of (top, t);
+	// optimal: the pricing problem was solved to optimality, i.e. pat has the smallest reduced cost
+	double priceExact(const Instance<MLBPTW>& inst, int top, int t, Pattern& pat, bool& optimal);
+
+	void extractSolution(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol) const;
+
+	double remainingTime() const;  // in seconds, infinity if there is no time limit
+
+	IloEnv env;
+	IloModel model;
+	IloCplex cplex;
+
+	IloObjective obj;
+	IloRangeArray item_rows;           // each item is covered exactly once
+	IloArray<IloRangeArray> bin_rows;  // each bin of level 1...m is used at most once
+	IloNumVarArray lambda;             // pattern variables
+	IloNumVarArray art;                // artificial variables, keep the restricted master feasible
+
+	std::vector<double> pi;                // duals of the item rows
+	std::vector<std::vector<double> > mu;  // duals of the bin rows for each level, index 0 is empty
+
+	std::vector<Pattern> m_patterns;
+	std::set<std::vector<int> > m_signatures;  // used to avoid duplicated columns
+
+	int m_time_limit;  // in seconds -> 0: no time limit
+	int m_threads;     // number of used threads, 0: default cplex setting
+	double m_lower_bound;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // __MLBPTW_CG_SOLVER_H__
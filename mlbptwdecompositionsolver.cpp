@@ -0,0 +1,172 @@
+#include "mlbptwdecompositionsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "intervalanalysis.h"
+#include "lowerbound.h"
+#include "users.h"
+
+#include <atomic>
+#include <chrono>
+#include <queue>
+#include <thread>
+#include <tuple>
+
+
+MLBPTWDecompositionSolver::Status MLBPTWDecompositionSolver::run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto remaining = [&]() {
+		if (m_time_limit <= 0)
+			return 0;
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+		return std::max(1, (int)(m_time_limit - d.count()));
+	};
+
+	IntervalAnalysis windows(inst);
+	const std::vector<std::vector<int> >& items = windows.components();
+	m_components = (int)items.size();
+	m_exact = true;
+	if (m_components <= 1)
+		return m_solver(inst, sol, m_time_limit);
+
+	std::vector<std::vector<std::vector<int> > > subset;
+	m_exact = split(inst, items, subset);
+	HEU_OUT(INFO) << "decomposition into " << m_components << " components, " << (m_exact ? "exact" : "heuristic") << " split of the bins" << std::endl;
+
+	// largest components first on the pool
+	std::vector<int> order(m_components);
+	for (int q = 0; q < m_components; q++)
+		order[q] = q;
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return items[a].size() > items[b].size(); });
+
+	std::vector<Instance<MLBPTW> > sub;
+	sub.reserve(m_components);
+	for (int q = 0; q < m_components; q++)
+		sub.emplace_back(inst, subset[q]);
+	std::vector<Solution<MLBPTW> > sub_sol;
+	sub_sol.reserve(m_components);
+	for (int q = 0; q < m_components; q++) {
+		sub_sol.emplace_back(sub[q]);
+		sub_sol[q].db = LowerBound<MLBPTW>::compute(sub[q]);
+	}
+	std::vector<Status> status(m_components, Aborted);
+
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		for (int t = next++; t < m_components; t = next++) {
+			const int q = order[t];
+			try {
+				status[q] = m_solver(sub[q], sub_sol[q], remaining());
+			} catch (const std::exception& exp) {
+				HEU_OUT(WARN) << "component " << q << ": " << exp.what() << std::endl;
+				status[q] = Aborted;
+			}
+			if ((status[q] == Optimal || status[q] == Feasible) && !SolutionVerifier<MLBPTW>::verify(sub[q], sub_sol[q]))
+				status[q] = Aborted;
+		}
+	};
+	std::vector<std::thread> threads;
+	for (int t = 1; t < std::min(m_threads, m_components); t++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	// merge the sub-solutions
+	bool optimal = m_exact, bounded = m_exact;
+	long db = 0;
+	for (int q = 0; q < m_components; q++) {
+		if (status[q] == Optimal || status[q] == Feasible) {
+			optimal = optimal && status[q] == Optimal;
+			bounded = bounded && sub_sol[q].db >= 0;
+			db += sub_sol[q].db;
+			continue;
+		}
+		HEU_OUT(DBG) << "component " << q << " with " << items[q].size() << " items is not solved" << std::endl;
+		if (m_exact && status[q] == Infeasible)
+			return Infeasible;
+		if (m_exact)
+			return Aborted;
+		HEU_OUT(INFO) << "heuristic split failed, solving the whole instance" << std::endl;
+		m_components = 1;
+		return m_solver(inst, sol, remaining());
+	}
+
+	sol.total_cost = 0;
+	sol.total_bins = 0;
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+	for (int q = 0; q < m_components; q++) {
+		for (int k = 0; k < inst.m; k++)
+			for (int i : sub[q].B[k])
+				if (sub_sol[q].item_to_bins[k][i] >= 0)
+					sol.item_to_bins[k][subset[q][k][i]] = subset[q][k + 1][sub_sol[q].item_to_bins[k][i]];
+		sol.total_cost += sub_sol[q].total_cost;
+		sol.total_bins += sub_sol[q].total_bins;
+	}
+	if (bounded)
+		sol.db = std::max(sol.db, (int)db);
+
+	if (!SolutionVerifier<MLBPTW>::verify(inst, sol)) {
+		HEU_OUT(WARN) << "merged solution is infeasible" << std::endl;
+		return Aborted;
+	}
+	return optimal || sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+bool MLBPTWDecompositionSolver::split(const Instance<MLBPTW>& inst, const std::vector<std::vector<int> >& items, std::vector<std::vector<std::vector<int> > >& subset) const
+{
+	const int r = (int)items.size();
+	subset.assign(r, std::vector<std::vector<int> >(inst.m + 1));
+
+	std::vector<double> size(r, 0);
+	double total = 0;
+	for (int q = 0; q < r; q++) {
+		subset[q][0] = items[q];
+		std::sort(subset[q][0].begin(), subset[q][0].end());
+		for (int i : items[q])
+			size[q] += inst.s[0][i];
+		total += size[q];
+	}
+
+	bool exact = true;
+	for (int k : inst.M) {
+		// a component never uses more bins than it has items
+		bool identical = true;
+		long needed = 0;
+		for (int j : inst.B[k])
+			identical = identical && std::make_tuple(inst.w[k][j], inst.c[k][j], inst.s[k][j]) == std::make_tuple(inst.w[k][0], inst.c[k][0], inst.s[k][0]);
+		for (int q = 0; q < r; q++)
+			needed += std::min(items[q].size(), (size_t)inst.n[k]);
+
+		if (identical && needed <= inst.n[k]) {
+			int j = 0;
+			for (int q = 0; q < r; q++)
+				for (int t = 0; t < (int)items[q].size() && t < inst.n[k]; t++)
+					subset[q][k].push_back(j++);
+			continue;
+		}
+		exact = false;
+
+		// deal the bins by increasing cost per capacity: components without a bin first, then the largest deficit of the share
+		std::vector<int> bins(inst.B[k]);
+		std::stable_sort(bins.begin(), bins.end(), [&](int a, int b) { return (long)inst.c[k][a] * inst.w[k][b] < (long)inst.c[k][b] * inst.w[k][a]; });
+		std::priority_queue<std::tuple<bool, double, int> > deficit;
+		for (int q = 0; q < r; q++)
+			deficit.emplace(true, total > 0 ? inst.n[k] * size[q] / total : 0.0, -q);
+		for (int j : bins) {
+			if (deficit.empty())
+				break;
+			const int q = -std::get<2>(deficit.top());
+			deficit.pop();
+			subset[q][k].push_back(j);
+			if (subset[q][k].size() < items[q].size())
+				deficit.emplace(false, (total > 0 ? inst.n[k] * size[q] / total : 0.0) - subset[q][k].size(), -q);
+		}
+		for (int q = 0; q < r; q++)
+			std::sort(subset[q][k].begin(), subset[q][k].end());
+	}
+	return exact;
+}
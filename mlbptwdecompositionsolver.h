@@ -0,0 +1,58 @@
+#ifndef __MLBPTW_DECOMPOSITION_SOLVER_H__
+#define __MLBPTW_DECOMPOSITION_SOLVER_H__
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Decomposition of the Multi-Level Bin Packing Problem with Time Windows into the connected components
+ * of the overlap graph of the time windows (see IntervalAnalysis). Items of different components never
+ * share a top-level bin, hence every component is an independent sub-instance with its own part of the bins.
+ *
+ *  *) split  -> a component with c items uses at most c bins on each level. If the bins of every level are
+ *               identical (capacity, cost, size) and min(c, n_k) bins can be given to each component, the split
+ *               is exact. Otherwise the bins of each level are dealt by increasing cost per capacity to the
+ *               component furthest below its share of the total item size (at least one bin each, at most c)
+ *  *) solve  -> the components are solved by the given solver on a pool of threads, largest component first
+ *  *) merge  -> the sub-solutions are verified (SolutionVerifier<MLBPTW>) and mapped back to the instance;
+ *               the objective is the sum over the components
+ *
+ *  Status Optimal if the split is exact and all components are solved to optimality (sol.db = sum of the
+ *  dual bounds). If a component fails after a heuristic split, the whole instance is given to the solver.
+ */
+class MLBPTWDecompositionSolver : public SolverStatus
+{
+public:
+	// solves a (sub-)instance within the time limit in seconds (0: no time limit)
+	typedef std::function<Status(const Instance<MLBPTW>&, Solution<MLBPTW>&, int)> ComponentSolver;
+
+	MLBPTWDecompositionSolver() : m_time_limit(0), m_threads(1), m_components(0), m_exact(false) { }
+
+	void setSolver(const ComponentSolver& solver) { m_solver = solver; }
+	void setTimeLimit(int time) { m_time_limit = time; }               // in seconds -> 0: no time limit
+	void setThreads(int number) { m_threads = std::max(1, number); }  // number of components solved in parallel
+
+	Status run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol);
+
+	int components() const { return m_components; }  // number of components from last run(...) call
+	bool exact() const { return m_exact; }            // split of the bins from last run(...) call was exact
+
+private:
+	// subset[q][k]: items/bins of level k of component q
+	bool split(const Instance<MLBPTW>& inst, const std::vector<std::vector<int> >& items, std::vector<std::vector<std::vector<int> > >& subset) const;
+
+	ComponentSolver m_solver;
+	int m_time_limit;
+	int m_threads;
+	int m_components;
+	bool m_exact;
+};
+
+#endif // __MLBPTW_DECOMPOSITION_SOLVER_H__
@@ -3,6 +3,10 @@
 #include "instance.h"
 #include "solution.h"
 #include "users.h"
+#include "intervalanalysis.h"
+
+#include <map>
+#include <tuple>
 
 void MLBPTWFormulation::createDecisionVariables(IloEnv env, const Instance<MLBPTW>& inst)
 {
@@ -35,6 +39,26 @@ void MLBPTWFormulation::createDecisionVariables(IloEnv env, const Instance<MLBPT
 
 	MLB_OUT(TRACE) << "added " << count << " ib_{kij} variables" << std::endl;
 
+	// the items of an independent set of the time windows are in distinct bins on every level: relabelling identical bins,
+	// the t-th item of the set only needs the first t + 1 bins of each bin type
+	IntervalAnalysis windows(inst);
+	const std::vector<int>& independent = windows.independentSet();
+	alpha = (int)independent.size();
+	symmetry = IloNumVarArray(env);
+	for (int k : inst.M) {
+		std::map<std::tuple<int, int, int>, int> seen;
+		std::vector<int> position(inst.n[k]);
+		for (int j : inst.B[k])
+			position[j] = seen[std::make_tuple(inst.w[k][j], inst.c[k][j], k < inst.m ? inst.s[k][j] : 0)]++;
+		for (int t = 0; t < alpha; t++)
+			for (int j : inst.B[k])
+				if (position[j] > t) {
+					ib[k][independent[t]][j].setUB(0);
+					symmetry.add(ib[k][independent[t]][j]);
+				}
+	}
+	MLB_OUT(TRACE) << "fixed " << symmetry.getSize() << " ib_{kij} variables for " << alpha << " items with pairwise disjoint time windows" << std::endl;
+
 
 
 	// decision variables y_{ki}
@@ -78,13 +102,14 @@ void MLBPTWFormulation::addConstraints(IloEnv env, IloModel model, const Instanc
 
 
 	// if two items with overlapping time windows are packed into the same top level bin the earliest packing time is as big as the latest starting time between those items
+	IntervalAnalysis windows(inst);
 	count = 0;
 	for (int a : inst.B[0]) {
 		for (int b = a + 1; b < inst.n[0]; b++) {
 			for (int top : inst.B[inst.m]) {
-				if (inst.l[a] < inst.e[b] || inst.e[a] > inst.l[b]) {
+				if (windows.separated(a, b)) {
 					// Non-overlapping time windows cannot be in the same bin
-					model.add(IloIfThen(env, ib[inst.m][a][top] >= 0.5, ib[inst.m][b][top] < 0.5));
+					model.add(ib[inst.m][a][top] + ib[inst.m][b][top] <= 1);
 				}
 				else if (inst.e[a] > inst.e[b]) {
 					model.add(IloIfThen(env, ib[inst.m][a][top] >= 0.5 && ib[inst.m][b][top] >= 0.5, u[b] >= u[a]));
@@ -98,6 +123,18 @@ void MLBPTWFormulation::addConstraints(IloEnv env, IloModel model, const Instanc
 	}
 	MLB_OUT(TRACE) << "added " << count << " constraints to enforce only items with overlapping time windows can be packed together and their earliest packing time coincides" << std::endl;
 
+	// clique cuts: at most one item of the independent set of the time windows in each top level bin
+	if (alpha > 1) {
+		for (int top : inst.B[inst.m]) {
+			IloExpr sum(env);
+			for (int i : windows.independentSet())
+				sum += ib[inst.m][i][top];
+			model.add(sum <= 1);
+			sum.end();
+		}
+		MLB_OUT(TRACE) << "added " << inst.n[inst.m] << " clique constraints on the " << alpha << " items with pairwise disjoint time windows" << std::endl;
+	}
+
 	// each item can only be assigned to 1 bin at each level
 	for (int k = 0; k <= inst.m; k++) {
 		for (int i : inst.B[0]) {
@@ -178,6 +215,18 @@ void MLBPTWFormulation::addConstraints(IloEnv env, IloModel model, const Instanc
 
 
 	MLB_OUT(TRACE) << "added " << count << " constraints such that the capacity of each used bin must not be exceeded" << std::endl;
+
+	// the items with pairwise disjoint time windows need distinct bins on every level
+	if (alpha > 1) {
+		for (int k : inst.M) {
+			IloExpr sum(env);
+			for (int j : inst.B[k])
+				sum += y[k][j];
+			model.add(sum >= alpha);
+			sum.end();
+		}
+		MLB_OUT(TRACE) << "added " << inst.m << " constraints such that at least " << alpha << " bins are used on each level" << std::endl;
+	}
 }
 
 void MLBPTWFormulation::addObjectiveFunction(IloEnv env, IloModel model, const Instance<MLBPTW>& inst)
@@ -219,3 +268,38 @@ void MLBPTWFormulation::extractSolution(IloCplex cplex, const Instance<MLBPTW>&
 
 	}
 }
+
+int MLBPTWFormulation::stages(const Instance<MLBPTW>& inst) const
+{
+	return inst.m;
+}
+
+void MLBPTWFormulation::addStageVariables(IloNumVarArray vars, const Instance<MLBPTW>& inst, int stage)
+{
+	// stage k decides the packing of the items/bins of level k into the bins of level k + 1
+	for (int i : inst.B[stage])
+		vars.add(x[stage][i]);
+	vars.add(y[stage + 1]);
+	for (int i : inst.B[0])
+		vars.add(ib[stage + 1][i]);
+	if (stage == 0) {
+		vars.add(y[0]);
+		for (int i : inst.B[0])
+			vars.add(ib[0][i]);
+	}
+
+	// start times follow from the top-level bins
+	if (stage == inst.m - 1)
+		for (int i : inst.B[0])
+			vars.add(u[i]);
+}
+
+bool MLBPTWFormulation::fixSolution(IloModel model, const Instance<MLBPTW>& inst, const Solution<MLBPTW>& sol, const std::vector<std::vector<char> >& free)
+{
+	fixAssignment(x, inst, sol, free);
+
+	// the fixed bins of the solution need not be the first ones of their type
+	for (IloInt q = 0; q < symmetry.getSize(); q++)
+		symmetry[q].setUB(1);
+	return true;
+}
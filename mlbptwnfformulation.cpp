@@ -289,3 +289,36 @@ void MLBPTWNFFormulation::extractSolution(IloCplex cplex, const Instance<MLBPTW>
 
 	}
 }
+
+int MLBPTWNFFormulation::stages(const Instance<MLBPTW>& inst) const
+{
+	return inst.m;
+}
+
+void MLBPTWNFFormulation::addStageVariables(IloNumVarArray vars, const Instance<MLBPTW>& inst, int stage)
+{
+	// stage k decides the packing of the items/bins of level k into the bins of level k + 1
+	for (int i : inst.B[stage])
+		vars.add(x[stage][i]);
+	for (int i : inst.B[stage])
+		vars.add(f[stage][i]);
+	vars.add(y[stage + 1]);
+	for (int i : inst.B[0])
+		vars.add(ib[stage + 1][i]);
+	if (stage == 0) {
+		vars.add(y[0]);
+		for (int i : inst.B[0])
+			vars.add(ib[0][i]);
+	}
+
+	// start times follow from the top-level bins
+	if (stage == inst.m - 1)
+		for (int i : inst.B[0])
+			vars.add(u[i]);
+}
+
+bool MLBPTWNFFormulation::fixSolution(IloModel model, const Instance<MLBPTW>& inst, const Solution<MLBPTW>& sol, const std::vector<std::vector<char> >& free)
+{
+	fixAssignment(x, inst, sol, free);
+	return true;
+}
@@ -15,6 +15,9 @@ public:
 	virtual void addConstraints(IloEnv env, IloModel model, const Instance<MLBPTW>& inst);
 	virtual void addObjectiveFunction(IloEnv env, IloModel model, const Instance<MLBPTW>& inst);
 	virtual void extractSolution(IloCplex cplex, const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol);
+	virtual int stages(const Instance<MLBPTW>& inst) const;
+	virtual void addStageVariables(IloNumVarArray vars, const Instance<MLBPTW>& inst, int stage);
+	virtual bool fixSolution(IloModel model, const Instance<MLBPTW>& inst, const Solution<MLBPTW>& sol, const std::vector<std::vector<char> >& free);
 private:
 
 	// binary decision variables x_{kij}: item/bin of index i of level k is inserted into bin j of level k + 1 (=1) or not (=0)
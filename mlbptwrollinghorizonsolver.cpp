@@ -0,0 +1,168 @@
+#include "mlbptwrollinghorizonsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "mlbptwsweepsolver.h"
+#include "users.h"
+
+#include <chrono>
+#include <climits>
+
+
+MLBPTWRollingHorizonSolver::Status MLBPTWRollingHorizonSolver::run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto elapsed = [](std::chrono::steady_clock::time_point since) {
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - since;
+		return d.count();
+	};
+
+	const int step = std::min(m_step, m_horizon);
+	std::vector<int> order(inst.B[0]);
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return inst.e[a] < inst.e[b]; });
+	const int last_e = order.empty() ? 0 : inst.e[order.back()];
+
+	std::vector<char> fixed(inst.n[0], 0);
+	std::vector<std::vector<char> > taken(inst.m + 1);
+	for (int k : inst.M)
+		taken[k].assign(inst.n[k], 0);
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+	m_windows.clear();
+
+	int pending = inst.n[0];
+	int t = order.empty() ? 0 : inst.e[order[0]];
+	while (pending > 0) {
+		// pending items starting until t + H
+		std::vector<std::vector<int> > subset(inst.m + 1);
+		for (int i : order) {
+			if (inst.e[i] > t + m_horizon)
+				break;
+			if (!fixed[i])
+				subset[0].push_back(i);
+		}
+		if (subset[0].empty()) {
+			t = inst.e[*std::find_if(order.begin(), order.end(), [&](int i) { return !fixed[i]; })];
+			continue;
+		}
+		const bool last = t + m_horizon >= last_e;
+
+		// free bins: at most one bin per element of the window from the cheapest per capacity and from the largest,
+		// such that the window can be packed alone and its largest elements fit (all free bins: no limit)
+		auto select = [&](bool all) {
+			for (int k : inst.M) {
+				std::vector<int> free;
+				for (int j : inst.B[k])
+					if (!taken[k][j])
+						free.push_back(j);
+				subset[k] = free;
+				if (!all && free.size() > subset[0].size()) {
+					std::stable_sort(free.begin(), free.end(), [&](int a, int b) { return (long)inst.c[k][a] * inst.w[k][b] < (long)inst.c[k][b] * inst.w[k][a]; });
+					std::stable_sort(subset[k].begin(), subset[k].end(), [&](int a, int b) { return inst.w[k][a] > inst.w[k][b]; });
+					subset[k].resize(subset[0].size());
+					subset[k].insert(subset[k].end(), free.begin(), free.begin() + subset[0].size());
+				}
+				std::sort(subset[k].begin(), subset[k].end());
+				subset[k].erase(std::unique(subset[k].begin(), subset[k].end()), subset[k].end());
+			}
+		};
+
+		int time = 0;
+		if (m_time_limit > 0) {
+			const int remaining = (std::max(0, last_e - t - m_horizon) + step - 1) / step + 1;
+			time = std::max(1, (int)((m_time_limit - elapsed(start)) / remaining));
+		}
+
+		// MIP formulation, the sweep if it finds no solution
+		Window window{t, (int)subset[0].size(), 0, 0, Aborted, -1, -1};
+		auto solve = [&](const Instance<MLBPTW>& sub, Solution<MLBPTW>& sub_sol) {
+			try {
+				MIPSolver<MLBPTW> mip_solver;
+				configure(mip_solver);
+				mip_solver.setThreads(m_threads);
+				mip_solver.setTimeLimit(time);
+				window.status = mip_solver.run(sub, sub_sol);
+			} catch (const std::exception& exp) {
+				HEU_OUT(WARN) << "rolling horizon: window " << t << ": " << exp.what() << std::endl;
+				window.status = Aborted;
+			}
+			if ((window.status == Optimal || window.status == Feasible) && SolutionVerifier<MLBPTW>::verify(sub, sub_sol)) {
+				window.db = sub_sol.db;
+				return true;
+			}
+			HEU_OUT(INFO) << "rolling horizon: no MIP solution for window " << t << ", using the sweep" << std::endl;
+			sub_sol = Solution<MLBPTW>(sub);
+			Status status = MLBPTWSweepSolver().run(sub, sub_sol);
+			return (status == Optimal || status == Feasible) && SolutionVerifier<MLBPTW>::verify(sub, sub_sol);
+		};
+
+		auto window_start = std::chrono::steady_clock::now();
+		select(false);
+		Instance<MLBPTW> sub(inst, subset);
+		Solution<MLBPTW> sub_sol(sub);
+		if (!solve(sub, sub_sol)) {
+			HEU_OUT(INFO) << "rolling horizon: window " << t << " retried with all free bins" << std::endl;
+			select(true);
+			sub = Instance<MLBPTW>(inst, subset);
+			sub_sol = Solution<MLBPTW>(sub);
+			if (!solve(sub, sub_sol)) {
+				HEU_OUT(WARN) << "rolling horizon: window " << t << " cannot be packed" << std::endl;
+				return Aborted;
+			}
+		}
+		window.objective = sub_sol.total_cost;
+
+		// fix the groups closing before t + step
+		std::vector<int> top(sub.B[0]);
+		for (int k = 0; k < inst.m; k++)
+			for (int& b : top)
+				b = sub_sol.item_to_bins[k][b];
+		std::vector<int> close(sub.n[inst.m], INT_MAX);
+		for (int i : sub.B[0])
+			close[top[i]] = std::min(close[top[i]], sub.l[i]);
+		for (int i : sub.B[0]) {
+			if (!last && close[top[i]] >= t + step)
+				continue;
+			for (int k = 0, x = i; k < inst.m; k++) {
+				const int b = sub_sol.item_to_bins[k][x];
+				sol.item_to_bins[k][subset[k][x]] = subset[k + 1][b];
+				taken[k + 1][subset[k + 1][b]] = 1;
+				x = b;
+			}
+			fixed[subset[0][i]] = 1;
+			window.fixed++;
+			pending--;
+		}
+
+		window.time = elapsed(window_start);
+		m_windows.push_back(window);
+		HEU_OUT(INFO) << "rolling horizon: window " << t << " with " << window.items << " items, " << window.fixed << " fixed, objective " << window.objective << std::endl;
+		t += step;
+	}
+
+	// cost of the used bins and waiting until the latest e of each top-level bin
+	sol.total_cost = 0;
+	sol.total_bins = 0;
+	for (int k : inst.M) {
+		std::vector<char> used(inst.n[k], 0);
+		for (int b : sol.item_to_bins[k - 1])
+			if (b >= 0 && !used[b]) {
+				used[b] = 1;
+				sol.total_cost += inst.c[k][b];
+				sol.total_bins++;
+			}
+	}
+	std::vector<int> top(inst.B[0]);
+	for (int k = 0; k < inst.m; k++)
+		for (int& b : top)
+			b = sol.item_to_bins[k][b];
+	std::vector<int> latest(inst.n[inst.m], INT_MIN);
+	for (int i : inst.B[0])
+		latest[top[i]] = std::max(latest[top[i]], inst.e[i]);
+	for (int i : inst.B[0])
+		sol.total_cost += inst.p * (latest[top[i]] - inst.e[i]);
+
+	HEU_OUT(INFO) << "rolling horizon: " << m_windows.size() << " windows, objective value " << sol.total_cost << std::endl;
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
@@ -0,0 +1,73 @@
+#ifndef __MLBPTW_ROLLING_HORIZON_SOLVER_H__
+#define __MLBPTW_ROLLING_HORIZON_SOLVER_H__
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+#include "mipsolver.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Rolling-horizon driver for the Multi-Level Bin Packing Problem with Time Windows on long horizons.
+ * Starting at t = min e, each window solves the MIP formulation on the sub-instance of the pending items
+ * with e_i <= t + H and the remaining bins, then advances t by the step.
+ *
+ *  *) bins    -> on each level at most one bin per window item by increasing cost per capacity and one by decreasing
+ *                capacity, such that the largest elements fit; all free bins if the window can not be packed
+ *  *) fixing  -> a top-level bin (group) is fixed if its common window closes before t + step (min l < t + step);
+ *                items of later windows start after t + H and cannot join it. All other items stay pending
+ *                and are solved again in the next window (overlap margin H - step), the last window fixes everything
+ *  *) time    -> the remaining total time is shared among the remaining windows
+ *
+ *  If the MIP finds no solution for a window, the time-window sweep packs it. The objective and gap of
+ *  each window are kept in windows(). Status Feasible (Optimal if the solution meets sol.db).
+ */
+class MLBPTWRollingHorizonSolver : public SolverStatus
+{
+public:
+	// statistics of one window
+	struct Window
+	{
+		int start;      // t
+		int items;      // items of the sub-instance
+		int fixed;      // items fixed after the window
+		double time;    // in seconds
+		Status status;  // of the MIP
+		int objective;  // of the sub-instance
+		int db;         // dual bound of the sub-instance, -1: unknown
+	};
+
+	MLBPTWRollingHorizonSolver() : m_horizon(1), m_step(1), m_time_limit(0), m_threads(1)
+	{
+		configure = [](MIPSolver<MLBPTW>&) { };
+	}
+
+	// MIP formulation solved in each window
+	template<typename T>
+	void setFormulation() { configure = [](MIPSolver<MLBPTW>& solver) { solver.template setFormulation<T>(); }; }
+
+	void setHorizon(int horizon) { m_horizon = std::max(1, horizon); }  // length H of a window
+	void setStep(int step) { m_step = std::max(1, step); }              // advance of t after each window, at most H
+	void setTimeLimit(int time) { m_time_limit = time; }                // in seconds -> 0: no time limit
+	void setThreads(int number) { m_threads = number; }                 // number of threads of the MIP solver
+
+	Status run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol);
+
+	const std::vector<Window>& windows() const { return m_windows; }  // windows from last run(...) call
+
+private:
+	std::function<void(MIPSolver<MLBPTW>&)> configure;
+
+	int m_horizon;
+	int m_step;
+	int m_time_limit;
+	int m_threads;
+	std::vector<Window> m_windows;
+};
+
+#endif // __MLBPTW_ROLLING_HORIZON_SOLVER_H__
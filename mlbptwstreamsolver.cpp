@@ -0,0 +1,143 @@
+#include "mlbptwstreamsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+
+MLBPTWStreamSolver::Status MLBPTWStreamSolver::run(std::istream& in, Instance<MLBPTW>& inst, Solution<MLBPTW>& sol)
+{
+	reset(inst);
+	for (int k = 0; k < inst.m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+
+	// packs the largest buffered item (or the first one whose window expires before the given time)
+	auto decide = [&](int expiry) {
+		auto it = std::find_if(buffer.begin(), buffer.end(), [&](int i) { return inst.l[i] < expiry; });
+		if (it == buffer.end())
+			it = std::max_element(buffer.begin(), buffer.end(), [&](int a, int b) { return inst.s[0][a] < inst.s[0][b]; });
+		int i = *it;
+		buffer.erase(it);
+		return pack(inst, sol, i);
+	};
+	auto expired = [&](int time) { return std::any_of(buffer.begin(), buffer.end(), [&](int i) { return inst.l[i] < time; }); };
+
+	int now = INT_MIN, size, e, l;
+	while (in >> size >> e >> l) {
+		Clock::time_point t = Clock::now();
+		if (e < now)
+			HEU_OUT(WARN) << "stream: item with e = " << e << " arrives after time " << now << std::endl;
+		now = std::max(now, e);
+
+		while (expired(now))
+			if (!decide(now))
+				return Aborted;
+
+		int i = inst.addItem(size, e, l);
+		m_smallest = std::min(m_smallest, size);
+		sol.item_to_bins[0].push_back(-1);
+		arrival.push_back(t);
+		buffer.push_back(i);
+		while ((int)buffer.size() > m_lookahead)
+			if (!decide(INT_MIN))
+				return Aborted;
+
+		// buffered items may still join a group whose window ends before the clock
+		int limit = now;
+		for (int b : buffer)
+			limit = std::min(limit, inst.e[b]);
+		close(limit);
+	}
+	while (!buffer.empty())
+		if (!decide(INT_MIN))
+			return Aborted;
+	close(INT_MAX);
+
+	// cost of the used bins and waiting until the latest e of each top-level bin
+	sol.total_cost = 0;
+	sol.total_bins = 0;
+	for (int k : inst.M) {
+		std::vector<char> used(inst.n[k], 0);
+		for (int b : sol.item_to_bins[k - 1])
+			if (b >= 0 && !used[b]) {
+				used[b] = 1;
+				sol.total_cost += inst.c[k][b];
+				sol.total_bins++;
+			}
+	}
+	for (int g = 0; g < (int)insertion.groups.size(); g++)
+		sol.total_cost += inst.p * (insertion.groups[g].u * insertion.groups[g].count - sum[g]);
+
+	HEU_OUT(INFO) << "stream: " << inst.n[0] << " items, " << insertion.groups.size() << " groups, cost " << sol.total_cost << std::endl;
+	return Feasible;
+}
+
+double MLBPTWStreamSolver::latencyMean() const
+{
+	return m_latency.empty() ? 0 : std::accumulate(m_latency.begin(), m_latency.end(), 0.0) / m_latency.size();
+}
+
+double MLBPTWStreamSolver::latency(double quantile) const
+{
+	if (m_latency.empty())
+		return 0;
+	std::vector<double> sorted(m_latency);
+	std::sort(sorted.begin(), sorted.end());
+	return sorted[std::min(sorted.size() - 1, (size_t)(quantile * sorted.size()))];
+}
+
+void MLBPTWStreamSolver::reset(const Instance<MLBPTW>& inst)
+{
+	insertion.reset(inst);
+	sum.clear();
+	items.clear();
+	closing = decltype(closing)();
+	buffer.clear();
+	arrival.assign(inst.n[0], Clock::now());
+	m_latency.clear();
+	m_committed = 0;
+	m_smallest = INT_MAX;
+}
+
+bool MLBPTWStreamSolver::pack(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol, int i)
+{
+	// a group which can not take the smallest item so far is considered full
+	int g = insertion.insert(inst, sol, i, m_candidates, m_smallest);
+	if (g < 0) {
+		HEU_OUT(WARN) << "stream: no bins left for item " << i << std::endl;
+		return false;
+	}
+	if (g == (int)sum.size()) {
+		sum.push_back(0);
+		items.emplace_back();
+	}
+	if (insertion.groups[g].l == inst.l[i])
+		closing.push(std::make_pair(inst.l[i], g));
+	sum[g] += inst.e[i];
+	items[g].push_back(i);
+
+	std::chrono::duration<double, std::micro> d = Clock::now() - arrival[i];
+	m_latency.push_back(d.count());
+	return true;
+}
+
+void MLBPTWStreamSolver::close(int limit)
+{
+	while (!closing.empty() && closing.top().first < limit) {
+		int g = closing.top().second;
+		GroupInsertion<MLBPTW>::Group& group = insertion.groups[g];
+		if (group.l == closing.top().first) {
+			insertion.close(g);
+			commit(group.top, items[g]);
+			m_committed++;
+			items[g] = std::vector<int>();
+			group.bins = std::vector<std::vector<int> >();
+			group.l = INT_MIN;
+		}
+		closing.pop();
+	}
+}
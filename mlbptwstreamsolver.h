@@ -0,0 +1,78 @@
+#ifndef __MLBPTW_STREAM_SOLVER_H__
+#define __MLBPTW_STREAM_SOLVER_H__
+
+#include <vector>
+#include <queue>
+#include <chrono>
+#include <istream>
+#include <functional>
+
+#include "problems.h"
+#include "solverstatus.h"
+#include "groupinsertion.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Online packing for the Multi-Level Bin Packing Problem with Time Windows. The bins of all levels are known,
+ * the items arrive one by one in order of e_i (lines "s e l") and are appended to the instance.
+ * The clock is the e of the last arrived item.
+ *
+ *  *) lookahead -> up to the given number of items are buffered before a decision, the largest buffered item is
+ *                  packed first; an item whose window expires before the next arrival (l_i < e) is packed at once
+ *  *) insertion -> as in the time-window sweep (see GroupInsertion): into the best fitting bin of the lowest level
+ *                  of an open group (missing bins below are opened by cost per capacity) or into a new group, smallest
+ *                  additional cost of the opened bins plus waiting penalty
+ *  *) commit    -> a group whose common window [u, l] closed before the clock and before the e of all buffered
+ *                  items can not take any further item, it is committed (see setCommit) and dropped from memory
+ *
+ *  The decision latency of each item (arrival until packing) is measured in microseconds.
+ *  Status Feasible after the end of the stream, Aborted if an item does not fit into the remaining bins.
+ */
+class MLBPTWStreamSolver : public SolverStatus
+{
+public:
+	// called for each committed group: top-level bin and its items
+	typedef std::function<void(int, const std::vector<int>&)> Commit;
+
+	MLBPTWStreamSolver() : m_lookahead(0), m_candidates(16), m_committed(0) { commit = [](int, const std::vector<int>&) { }; }
+
+	void setLookahead(int items) { m_lookahead = std::max(0, items); }  // number of buffered items, 0: immediate decisions
+	void setCandidates(int number) { m_candidates = number; }           // number of open groups evaluated for each item
+	void setCommit(const Commit& callback) { commit = callback; }
+
+	// packs the items of the stream into the bins of inst, the items are appended to inst
+	Status run(std::istream& in, Instance<MLBPTW>& inst, Solution<MLBPTW>& sol);
+
+	int committed() const { return m_committed; }  // number of committed groups from last run(...) call
+
+	// decision latency in microseconds from last run(...) call: mean and quantile (0.5: median, 1: maximum)
+	double latencyMean() const;
+	double latency(double quantile) const;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	void reset(const Instance<MLBPTW>& inst);
+	bool pack(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol, int i);
+	void close(int limit);
+
+	Commit commit;
+	int m_lookahead;
+	int m_candidates;
+	int m_committed;
+	std::vector<double> m_latency;
+	int m_smallest;  // size of the smallest item so far
+
+	// unused bins of each level sorted by capacity with their cost per capacity, residual capacity of all bins, open groups
+	GroupInsertion<MLBPTW> insertion;
+
+	std::vector<long> sum;                   // sum of e of the items of each group
+	std::vector<std::vector<int> > items;    // items of each uncommitted group
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int> >, std::greater<std::pair<int, int> > > closing;
+	std::vector<int> buffer;                 // undecided items in order of arrival
+	std::vector<Clock::time_point> arrival;  // of each item
+};
+
+#endif // __MLBPTW_STREAM_SOLVER_H__
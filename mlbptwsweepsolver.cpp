@@ -0,0 +1,142 @@
+#include "mlbptwsweepsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "users.h"
+#include "segmenttree.h"
+#include "groupinsertion.h"
+
+#include <algorithm>
+#include <queue>
+#include <climits>
+
+
+MLBPTWSweepSolver::Status MLBPTWSweepSolver::run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol)
+{
+	if (sweep(inst, sol, false) || sweep(inst, sol, true))
+		return Feasible;
+
+	HEU_OUT(WARN) << "sweep: no feasible packing found" << std::endl;
+	return Aborted;
+}
+
+bool MLBPTWSweepSolver::sweep(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol, bool stabbing) const
+{
+	const int m = inst.m;
+
+	for (int k = 0; k < m; k++)
+		sol.item_to_bins[k].assign(inst.n[k], -1);
+	sol.total_bins = 0;
+	sol.total_cost = 0;
+
+	// bins of each level sorted by capacity and their residual capacities, shared with the downsizing below
+	GroupInsertion<MLBPTW> insertion;
+	insertion.reset(inst);
+	const std::vector<std::vector<int> >& sorted = insertion.sorted;
+	const std::vector<std::vector<int> >& cap = insertion.cap;
+	const std::vector<std::vector<int> >& position = insertion.position;
+	std::vector<std::vector<int> >& residual = insertion.residual;
+	std::vector<std::vector<char> >& used = insertion.used;
+
+	const std::vector<GroupInsertion<MLBPTW>::Group>& groups = insertion.groups;
+	std::vector<int> group_of(inst.n[0], -1);
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int> >, std::greater<std::pair<int, int> > > closing;
+
+	// sweep time of each item: e_i or its stabbing time (minimum number of points hitting all windows)
+	std::vector<int> time(inst.e);
+	std::vector<int> order(inst.B[0]);
+	if (stabbing) {
+		std::sort(order.begin(), order.end(), [&](int a, int b) { return inst.l[a] != inst.l[b] ? inst.l[a] < inst.l[b] : a < b; });
+		int point = INT_MIN;
+		for (int q = 0; q < (int)order.size(); q++) {
+			if (q == 0 || inst.e[order[q]] > point)
+				point = inst.l[order[q]];
+			time[order[q]] = point;
+		}
+	}
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		if (time[a] != time[b])
+			return time[a] < time[b];
+		return inst.e[a] != inst.e[b] ? inst.e[a] < inst.e[b] : (inst.s[0][a] != inst.s[0][b] ? inst.s[0][a] > inst.s[0][b] : a < b);
+	});
+
+	int min_size = INT_MAX;
+	for (int i : inst.B[0])
+		min_size = std::min(min_size, inst.s[0][i]);
+
+	for (int i : order) {
+		// groups closed before the sweep time are retired
+		while (!closing.empty() && closing.top().first < time[i]) {
+			int g = closing.top().second;
+			if (groups[g].l == closing.top().first)
+				insertion.close(g);
+			closing.pop();
+		}
+
+		int g = insertion.insert(inst, sol, i, m_candidates, min_size);
+		if (g < 0) {
+			HEU_OUT(DBG) << "no feasible insertion for item " << i << (stabbing ? " (stabbing order)" : "") << std::endl;
+			return false;
+		}
+		if (groups[g].l == inst.l[i])
+			closing.push(std::make_pair(groups[g].l, g));
+		group_of[i] = g;
+	}
+
+	// downsizing (bottom-up): exchange each used bin for the cheapest unused bin holding its content and fitting into the parent
+	int exchanged = 0;
+	for (int k : inst.M) {
+		MinTree cost((int)sorted[k].size());
+		for (int q = 0; q < (int)sorted[k].size(); q++)
+			if (!used[k][sorted[k][q]])
+				cost.set(q, inst.c[k][sorted[k][q]]);
+
+		std::vector<std::vector<int> > children(inst.n[k]);
+		for (int c : inst.B[k - 1])
+			if (sol.item_to_bins[k - 1][c] >= 0)
+				children[sol.item_to_bins[k - 1][c]].push_back(c);
+
+		std::vector<int> bins;
+		for (int j : inst.B[k])
+			if (used[k][j])
+				bins.push_back(j);
+		auto load = [&](int j) { return inst.w[k][j] - residual[k][j]; };
+		std::sort(bins.begin(), bins.end(), [&](int a, int b) { return load(a) > load(b); });
+
+		for (int j : bins) {
+			int q = cost.argmin((int)(std::lower_bound(cap[k].begin(), cap[k].end(), load(j)) - cap[k].begin()));
+			if (q < 0 || inst.c[k][sorted[k][q]] >= inst.c[k][j])
+				continue;
+			int r = sorted[k][q];
+			if (k < m) {
+				int parent = sol.item_to_bins[k][j];
+				if (inst.s[k][r] > inst.s[k][j] + residual[k + 1][parent])
+					continue;
+				residual[k + 1][parent] += inst.s[k][j] - inst.s[k][r];
+				sol.item_to_bins[k][r] = parent;
+				sol.item_to_bins[k][j] = -1;
+			}
+			for (int c : children[j])
+				sol.item_to_bins[k - 1][c] = r;
+			residual[k][r] = inst.w[k][r] - load(j);
+			residual[k][j] = inst.w[k][j];
+			used[k][r] = 1;
+			used[k][j] = 0;
+			cost.remove(q);
+			cost.set(position[k][j], inst.c[k][j]);
+			exchanged++;
+		}
+	}
+
+	for (int k : inst.M)
+		for (int j : inst.B[k])
+			if (used[k][j]) {
+				sol.total_bins++;
+				sol.total_cost += inst.c[k][j];
+			}
+	for (int i : inst.B[0])
+		sol.total_cost += inst.p * (groups[group_of[i]].u - inst.e[i]);
+
+	HEU_OUT(INFO) << "sweep: " << groups.size() << " groups, " << sol.total_bins << " bins, " << exchanged << " downsized, cost " << sol.total_cost << std::endl;
+	return true;
+}
@@ -0,0 +1,49 @@
+#ifndef __MLBPTW_SWEEP_SOLVER_H__
+#define __MLBPTW_SWEEP_SOLVER_H__
+
+#include <vector>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Time-window sweep heuristic for the Multi-Level Bin Packing Problem with Time Windows.
+ * Items are processed by increasing earliest starting time e_i. The solver keeps a set
+ * of groups, each group is a top-level bin together with its packing tree and the
+ * common start interval [u, l] = [max e, min l] of its items.
+ *
+ *  *) insertion -> the item is inserted into the (best fitting) bin of the lowest level of the group
+ *                  with enough residual capacity, missing bins below are opened (lowest cost per capacity)
+ *  *) cost      -> cost of the opened bins plus p * (e_i - u) * (number of items of the group),
+ *                  since all items of the group start at e_i afterwards
+ *  *) new group -> a new top-level bin with a chain of new bins, no penalty
+ *
+ *  The item goes into the group with the smallest additional cost. Groups whose window closed are
+ *  retired and only the groups with the latest start u are evaluated, hence the sweep runs in
+ *  O(n log n) for a bounded number of bins per group. Finally, every used bin is exchanged for
+ *  the cheapest unused bin which holds its content and still fits into its parent (bottom-up).
+ *
+ *  On instances with many narrow windows the sweep by e_i may run out of bins. Then the sweep is
+ *  repeated in the order of the stabbing times (minimum set of points hitting all windows), which
+ *  keeps the items sharing a point together; an item may then also be delayed itself (p * (u - e_i)).
+ */
+class MLBPTWSweepSolver : public SolverStatus
+{
+public:
+	MLBPTWSweepSolver() : m_candidates(16) { }
+
+	void setCandidates(int number) { m_candidates = number; }  // number of open groups evaluated for each item
+
+	Status run(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol);
+
+private:
+	// stabbing: items are swept by their stabbing time instead of e_i (retry if the bins run out)
+	bool sweep(const Instance<MLBPTW>& inst, Solution<MLBPTW>& sol, bool stabbing) const;
+
+	int m_candidates;
+};
+
+#endif // __MLBPTW_SWEEP_SOLVER_H__
@@ -0,0 +1,292 @@
+#ifndef __OPEN_BINS_H__
+#define __OPEN_BINS_H__
+
+#include <vector>
+#include <set>
+#include <climits>
+#include <utility>
+
+// AVX2 kernels with runtime dispatch on x86 with GCC/Clang
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define OPEN_BINS_AVX2
+#include <immintrin.h>
+#endif
+
+#include "segmenttree.h"
+
+/**
+ * Residual capacities of the opened bins of a constructive heuristic (structure of arrays,
+ * slot = opening order, -1: closed/removed) with first-fit, best-fit and worst-fit queries.
+ * Ties are broken by the smallest slot.
+ *
+ *  *) scan -> up to threshold slots, the contiguous residual array is scanned by a vectorised
+ *             kernel (AVX2, 8 bins per instruction, chosen at runtime; scalar loop if the CPU
+ *             or compiler has no AVX2)
+ *  *) tree -> for more slots, the structure of the main query is maintained: a segment tree (see MaxTree)
+ *             for first-fit or an ordered set of (residual, slot) for best-fit/worst-fit, both with
+ *             O(log n) queries and updates; the other queries still scan
+ *
+ *  By default the threshold depends on the main query (see bench/openbins_bench.cpp): the ordered set
+ *  beats the vectorised scan for best-fit and worst-fit from about 64 slots, while the first-fit scan
+ *  stops at the first fitting slot and stays faster than the segment tree, so first-fit always scans.
+ */
+class OpenBins
+{
+public:
+	enum Query
+	{
+		FirstFit,
+		BestFit,
+		WorstFit
+	};
+
+	// number of slots above which best-fit and worst-fit switch to the ordered set by default
+	static const int SORTED_THRESHOLD = 64;
+
+	// threshold < 0: by query, SORTED_THRESHOLD for best-fit/worst-fit and no tree for first-fit
+	OpenBins(Query query = FirstFit, int threshold = -1)
+		: m_query(query), m_threshold(threshold >= 0 ? threshold : (query == FirstFit ? INT_MAX : SORTED_THRESHOLD)),
+		  m_tree(0), m_tree_size(0), m_tree_mode(false) { }
+
+	int size() const { return (int)m_residual.size(); }
+	int residual(int slot) const { return m_residual[slot]; }
+
+	// opens a new slot, returns its index
+	int add(int residual)
+	{
+		m_residual.push_back(-1);
+		if ((!m_tree_mode && size() > m_threshold) || (m_tree_mode && m_query == FirstFit && size() > m_tree_size))
+			build();
+		set(size() - 1, residual);
+		return size() - 1;
+	}
+
+	// new residual of slot, -1 removes the slot from all queries
+	void set(int slot, int residual)
+	{
+		if (m_tree_mode && m_query == FirstFit)
+			m_tree.set(slot, residual);
+		else if (m_tree_mode) {
+			if (m_residual[slot] >= 0)
+				m_sorted.erase(std::make_pair(m_residual[slot], slot));
+			if (residual >= 0)
+				m_sorted.insert(std::make_pair(residual, slot));
+		}
+		m_residual[slot] = residual;
+	}
+
+	// first slot >= from with residual >= size, -1 if there is none
+	int firstFit(int size, int from = 0) const
+	{
+		if (m_tree_mode && m_query == FirstFit)
+			return m_tree.findFirst(from, size);
+		return firstFit(m_residual.data(), (int)m_residual.size(), size, from);
+	}
+
+	// slot with the smallest residual >= size
+	int bestFit(int size) const
+	{
+		if (m_tree_mode && m_query != FirstFit) {
+			auto it = m_sorted.lower_bound(std::make_pair(size, -1));
+			return it == m_sorted.end() ? -1 : it->second;
+		}
+		return bestFit(m_residual.data(), (int)m_residual.size(), size);
+	}
+
+	// slot with the largest residual >= size
+	int worstFit(int size) const
+	{
+		if (m_tree_mode && m_query != FirstFit) {
+			if (m_sorted.empty() || m_sorted.rbegin()->first < size)
+				return -1;
+			return m_sorted.lower_bound(std::make_pair(m_sorted.rbegin()->first, -1))->second;
+		}
+		return worstFit(m_residual.data(), (int)m_residual.size(), size);
+	}
+
+	/** kernels over contiguous residual capacities ******************************************/
+
+	// the AVX2 kernels are compiled for the AVX2 target and used if the CPU supports it, no -mavx2 needed
+	static bool vectorised()
+	{
+#if defined(OPEN_BINS_AVX2)
+		static const bool supported = __builtin_cpu_supports("avx2");
+		return supported;
+#else
+		return false;
+#endif
+	}
+
+	static int firstFit(const int* residual, int n, int size, int from = 0)
+	{
+#if defined(OPEN_BINS_AVX2)
+		if (vectorised())
+			return firstFitAVX2(residual, n, size, from);
+#endif
+		return firstFitScan(residual, n, size, from);
+	}
+
+	static int bestFit(const int* residual, int n, int size)
+	{
+#if defined(OPEN_BINS_AVX2)
+		if (vectorised())
+			return bestFitAVX2(residual, n, size);
+#endif
+		return bestFitScan(residual, n, size);
+	}
+
+	static int worstFit(const int* residual, int n, int size)
+	{
+#if defined(OPEN_BINS_AVX2)
+		if (vectorised())
+			return worstFitAVX2(residual, n, size);
+#endif
+		return worstFitScan(residual, n, size);
+	}
+
+	// scalar kernels
+	static int firstFitScan(const int* residual, int n, int size, int from = 0)
+	{
+		for (int i = from; i < n; i++)
+			if (residual[i] >= size)
+				return i;
+		return -1;
+	}
+
+	static int bestFitScan(const int* residual, int n, int size)
+	{
+		int best = -1, best_value = INT_MAX;
+		for (int i = 0; i < n; i++)
+			if (residual[i] >= size && residual[i] < best_value) {
+				best_value = residual[i];
+				best = i;
+			}
+		return best;
+	}
+
+	static int worstFitScan(const int* residual, int n, int size)
+	{
+		int best = -1, best_value = size - 1;
+		for (int i = 0; i < n; i++)
+			if (residual[i] > best_value) {
+				best_value = residual[i];
+				best = i;
+			}
+		return best;
+	}
+
+#if defined(OPEN_BINS_AVX2)
+	// AVX2 kernels, 8 bins per instruction
+	__attribute__((target("avx2")))
+	static int firstFitAVX2(const int* residual, int n, int size, int from = 0)
+	{
+		int i = from;
+		const __m256i need = _mm256_set1_epi32(size - 1);
+		for (; i + 8 <= n; i += 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)(residual + i));
+			int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, need)));
+			if (mask)
+				return i + __builtin_ctz(mask);
+		}
+		for (; i < n; i++)
+			if (residual[i] >= size)
+				return i;
+		return -1;
+	}
+
+	__attribute__((target("avx2")))
+	static int bestFitAVX2(const int* residual, int n, int size)
+	{
+		int best = -1, best_value = INT_MAX, i = 0;
+		if (n >= 8) {
+			const __m256i need = _mm256_set1_epi32(size - 1);
+			const __m256i none = _mm256_set1_epi32(INT_MAX);
+			__m256i value = none, index = _mm256_set1_epi32(-1);
+			__m256i current = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			const __m256i step = _mm256_set1_epi32(8);
+			for (; i + 8 <= n; i += 8) {
+				__m256i v = _mm256_loadu_si256((const __m256i*)(residual + i));
+				__m256i cand = _mm256_blendv_epi8(none, v, _mm256_cmpgt_epi32(v, need));
+				__m256i better = _mm256_cmpgt_epi32(value, cand);  // strictly smaller: the first slot wins ties within a lane
+				value = _mm256_blendv_epi8(value, cand, better);
+				index = _mm256_blendv_epi8(index, current, better);
+				current = _mm256_add_epi32(current, step);
+			}
+			alignas(32) int values[8], indices[8];
+			_mm256_store_si256((__m256i*)values, value);
+			_mm256_store_si256((__m256i*)indices, index);
+			for (int q = 0; q < 8; q++)
+				if (indices[q] >= 0 && (values[q] < best_value || (values[q] == best_value && indices[q] < best))) {
+					best_value = values[q];
+					best = indices[q];
+				}
+		}
+		for (; i < n; i++)
+			if (residual[i] >= size && residual[i] < best_value) {
+				best_value = residual[i];
+				best = i;
+			}
+		return best;
+	}
+
+	__attribute__((target("avx2")))
+	static int worstFitAVX2(const int* residual, int n, int size)
+	{
+		int best = -1, best_value = size - 1, i = 0;
+		if (n >= 8) {
+			__m256i value = _mm256_set1_epi32(size - 1), index = _mm256_set1_epi32(-1);
+			__m256i current = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			const __m256i step = _mm256_set1_epi32(8);
+			for (; i + 8 <= n; i += 8) {
+				__m256i v = _mm256_loadu_si256((const __m256i*)(residual + i));
+				__m256i better = _mm256_cmpgt_epi32(v, value);
+				value = _mm256_blendv_epi8(value, v, better);
+				index = _mm256_blendv_epi8(index, current, better);
+				current = _mm256_add_epi32(current, step);
+			}
+			alignas(32) int values[8], indices[8];
+			_mm256_store_si256((__m256i*)values, value);
+			_mm256_store_si256((__m256i*)indices, index);
+			for (int q = 0; q < 8; q++)
+				if (indices[q] >= 0 && (values[q] > best_value || (values[q] == best_value && indices[q] < best))) {
+					best_value = values[q];
+					best = indices[q];
+				}
+		}
+		for (; i < n; i++)
+			if (residual[i] > best_value) {
+				best_value = residual[i];
+				best = i;
+			}
+		return best;
+	}
+#endif
+
+private:
+	// switches to (or grows) the tree representation
+	void build()
+	{
+		m_tree_mode = true;
+		if (m_query == FirstFit) {
+			m_tree_size = std::max(2 * m_threshold, 2 * size());
+			m_tree = MaxTree(m_tree_size);
+		}
+		for (int slot = 0; slot < size(); slot++)
+			if (m_residual[slot] >= 0) {
+				if (m_query == FirstFit)
+					m_tree.set(slot, m_residual[slot]);
+				else
+					m_sorted.insert(std::make_pair(m_residual[slot], slot));
+			}
+	}
+
+	std::vector<int> m_residual;
+	Query m_query;
+	int m_threshold;
+	MaxTree m_tree;
+	int m_tree_size;
+	bool m_tree_mode;
+	std::set<std::pair<int, int> > m_sorted;
+};
+
+#endif // __OPEN_BINS_H__
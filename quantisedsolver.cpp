@@ -0,0 +1,93 @@
+#include "quantisedsolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "lowerbound.h"
+#include "users.h"
+
+#include <cmath>
+#include <limits>
+#include <set>
+
+
+template<typename ProbT>
+typename QuantisedSolver<ProbT>::Status QuantisedSolver<ProbT>::run(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	Instance<ProbT> coarse = coarsen(inst);
+	HEU_OUT(INFO) << "quantised: " << m_classes << " different sizes, inflation " << m_inflation << std::endl;
+
+	Solution<ProbT> coarse_sol(coarse);
+	Status status = Aborted;
+	try {
+		status = m_solver(coarse, coarse_sol);
+	} catch (const std::exception& exp) {
+		HEU_OUT(WARN) << "quantised: " << exp.what() << std::endl;
+	}
+	if (status != Optimal && status != Feasible) {
+		HEU_OUT(WARN) << "quantised: coarse instance not solved" << std::endl;
+		return Aborted;
+	}
+
+	// same items and bins, the dual bound of the coarse instance is no bound of the instance
+	sol.item_to_bins = coarse_sol.item_to_bins;
+	sol.total_cost = coarse_sol.total_cost;
+	sol.total_bins = coarse_sol.total_bins;
+	if (!SolutionVerifier<ProbT>::verify(inst, sol)) {
+		HEU_OUT(WARN) << "quantised: solution of the coarse instance is infeasible" << std::endl;
+		return Aborted;
+	}
+
+	sol.db = std::max(sol.db, LowerBound<ProbT>::compute(inst));
+	m_gap = sol.total_cost > 0 ? (double)(sol.total_cost - sol.db) / sol.total_cost : 0;
+	HEU_OUT(INFO) << "quantised: cost " << sol.total_cost << ", lower bound " << sol.db << ", proven gap " << m_gap * 100 << "%" << std::endl;
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+template<typename ProbT>
+Instance<ProbT> QuantisedSolver<ProbT>::coarsen(const Instance<ProbT>& inst)
+{
+	const int q = m_rounding == Grid ? std::max(1, (int)m_step) : 1;
+	Instance<ProbT> coarse(inst);
+	std::set<int> sizes;
+	m_inflation = 1;
+	for (int k : inst.M) {
+		// growth of the elements of level k - 1 and shrinking of the capacities of level k
+		double grow = 1, shrink = 1;
+		for (int x : inst.B[k - 1]) {
+			coarse.s[k - 1][x] = round(inst.s[k - 1][x]);
+			sizes.insert(coarse.s[k - 1][x]);
+			if (inst.s[k - 1][x] > 0)
+				grow = std::max(grow, (double)q * coarse.s[k - 1][x] / inst.s[k - 1][x]);
+		}
+		for (int j : inst.B[k]) {
+			coarse.w[k][j] = inst.w[k][j] / q;
+			if (inst.w[k][j] > 0)
+				shrink = std::max(shrink, coarse.w[k][j] > 0 ? (double)inst.w[k][j] / (q * coarse.w[k][j]) : std::numeric_limits<double>::infinity());
+		}
+		m_inflation = std::max(m_inflation, grow * shrink);
+	}
+	m_classes = (int)sizes.size();
+	return coarse;
+}
+
+template<typename ProbT>
+int QuantisedSolver<ProbT>::round(int size) const
+{
+	if (m_rounding == Grid) {
+		const int q = std::max(1, (int)m_step);
+		return (size + q - 1) / q;
+	}
+	if (size <= 1 || m_step <= 1)
+		return size;
+	// smallest class ceil(r^t) >= size
+	const double r = m_step;
+	int t = std::max(0, (int)std::floor(std::log((double)size) / std::log(r)) - 1);
+	while (std::ceil(std::pow(r, t)) < size)
+		t++;
+	return (int)std::ceil(std::pow(r, t));
+}
+
+// Instantiate all required quantised solver classes
+template class QuantisedSolver<MLBP>;
+template class QuantisedSolver<MLBPTW>;
@@ -0,0 +1,69 @@
+#ifndef __QUANTISED_SOLVER_H__
+#define __QUANTISED_SOLVER_H__
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Approximation of the Multi-Level Bin Packing Problem (with time windows) with huge, fine-grained sizes:
+ * the sizes of the items and bins are rounded up and the capacities rounded down, the coarse instance is solved
+ * by the given solver and its solution is used for the instance (same items and bins).
+ *
+ *  *) grid      -> s' = ceil(s / q), w' = floor(w / q): the capacities of the coarse instance are q times smaller,
+ *                  which shrinks the graphs of the arc-flow formulation and the tables of size-based algorithms
+ *  *) geometric -> each size is rounded up to the next class ceil((1 + eps)^t), the capacities are kept:
+ *                  at most log_{1+eps}(w) different sizes (item types of the arc-flow formulation)
+ *
+ *  Each bin of the coarse solution holds a total size of at most q * floor(w / q) <= w, hence the solution is
+ *  feasible. Rounding only restricts the packings, so the loss is bounded by the gap against LowerBound of the
+ *  instance, which is reported (sol.db). inflation() is the largest factor by which an element grows relative to a
+ *  capacity, i.e. every packing of the instance with all sizes multiplied by it is a packing of the coarse instance.
+ *
+ *  Status Feasible (Optimal if the cost meets the lower bound), Aborted if the coarse instance is not solved.
+ */
+template<typename ProbT>
+class QuantisedSolver : public SolverStatus
+{
+public:
+	// solves the coarse instance
+	typedef std::function<Status(const Instance<ProbT>&, Solution<ProbT>&)> CoarseSolver;
+
+	enum Rounding
+	{
+		Grid,       // step q >= 1
+		Geometric   // factor 1 + eps > 1
+	};
+
+	QuantisedSolver(Rounding rounding = Grid, double step = 1) : m_rounding(rounding), m_step(step), m_inflation(1), m_classes(0), m_gap(0) { }
+
+	void setSolver(const CoarseSolver& solver) { m_solver = solver; }
+
+	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
+	// coarse instance of the given instance, the indices of the items and bins are kept
+	Instance<ProbT> coarsen(const Instance<ProbT>& inst);
+
+	double inflation() const { return m_inflation; }  // largest factor of growth of an element relative to a capacity
+	int classes() const { return m_classes; }         // number of different sizes of the coarse instance
+	double gap() const { return m_gap; }              // proven gap (cost - lower bound) / cost from last run(...) call
+
+private:
+	int round(int size) const;
+
+	CoarseSolver m_solver;
+	Rounding m_rounding;
+	double m_step;
+
+	double m_inflation;
+	int m_classes;
+	double m_gap;
+};
+
+#endif // __QUANTISED_SOLVER_H__
@@ -0,0 +1,96 @@
+#ifndef __SEGMENT_TREE_H__
+#define __SEGMENT_TREE_H__
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+/**
+ * Segment tree over integer values (e.g. residual capacities of opened bins).
+ * Supports point updates and the search for the leftmost index with value >= x in O(log n).
+ * Unset/removed entries are -1.
+ */
+class MaxTree
+{
+public:
+	MaxTree(int n) : size(1)
+	{
+		while (size < std::max(1, n))
+			size *= 2;
+		tree.assign(2 * size, -1);
+	}
+
+	void set(int i, int value)
+	{
+		i += size;
+		tree[i] = value;
+		for (i /= 2; i >= 1; i /= 2)
+			tree[i] = std::max(tree[2 * i], tree[2 * i + 1]);
+	}
+
+	int get(int i) const { return tree[i + size]; }
+
+	// leftmost index >= from with value >= x, -1 if there is none
+	int findFirst(int from, int x) const { return findFirst(1, 0, size - 1, from, x); }
+
+private:
+	int findFirst(int node, int lo, int hi, int from, int x) const
+	{
+		if (hi < from || tree[node] < x)
+			return -1;
+		if (lo == hi)
+			return lo;
+		int mid = (lo + hi) / 2;
+		int res = findFirst(2 * node, lo, mid, from, x);
+		return res != -1 ? res : findFirst(2 * node + 1, mid + 1, hi, from, x);
+	}
+
+	int size;
+	std::vector<int> tree;
+};
+
+/**
+ * Segment tree returning the index of the minimum value within a range in O(log n),
+ * e.g. the cheapest unused bin among the bins (sorted by capacity) an element fits into.
+ * Unset/removed entries are +infinity.
+ */
+class MinTree
+{
+public:
+	MinTree(int n) : size(1)
+	{
+		while (size < std::max(1, n))
+			size *= 2;
+		tree.assign(2 * size, std::make_pair(std::numeric_limits<double>::infinity(), -1));
+	}
+
+	void set(int i, double value)
+	{
+		i += size;
+		tree[i] = std::make_pair(value, value < std::numeric_limits<double>::infinity() ? i - size : -1);
+		for (i /= 2; i >= 1; i /= 2)
+			tree[i] = std::min(tree[2 * i], tree[2 * i + 1]);
+	}
+
+	void remove(int i) { set(i, std::numeric_limits<double>::infinity()); }
+
+	// index of the minimum of [from, to), -1 if all entries are removed; to < 0: up to the end
+	int argmin(int from, int to = -1) const
+	{
+		std::pair<double, int> best(std::numeric_limits<double>::infinity(), -1);
+		for (int lo = from + size, hi = (to < 0 ? size : to) + size; lo < hi; lo /= 2, hi /= 2) {
+			if (lo & 1)
+				best = std::min(best, tree[lo++]);
+			if (hi & 1)
+				best = std::min(best, tree[--hi]);
+		}
+		return best.second;
+	}
+
+private:
+	int size;
+	std::vector<std::pair<double, int> > tree;
+};
+
+#endif // __SEGMENT_TREE_H__
@@ -91,7 +91,7 @@ bool SolutionVerifier<MLBP>::verify(const Instance<MLBP>& inst, const Solution<M
 				}
 				ret = false;
 			}
-			else if (k > 0 && bin > 0 && usedBins[k-1][i] < 0) {
+			else if (k > 0 && bin >= 0 && usedBins[k-1][i] < 0) {
 				if (error_msg) {
 					std::stringstream ss;
 					ss << "Bin with id " << i << " of level " << k << " is assigned to a bin but not used.";
@@ -105,10 +105,10 @@ bool SolutionVerifier<MLBP>::verify(const Instance<MLBP>& inst, const Solution<M
 			}
 		}
 		for (int bin = 0; bin < inst.n[k + 1]; bin++) {
-			if (capacity[bin] > inst.c[k+1][bin]) {
+			if (capacity[bin] > inst.w[k+1][bin]) {
 				if (error_msg) {
 					std::stringstream ss;
-					ss << "Bin " << bin << " of level " << k << " with capacity " << inst.c[k][bin] << " exceeds maximum capacity (" << capacity[bin] << ").";
+					ss << "Bin " << bin << " of level " << k+1 << " with content of size " << capacity[bin] << " exceeds maximum capacity (" << inst.w[k+1][bin] << ").";
 					MLB_OUT(TRACE) << ss.str();
 					error_msg->push_back(ss.str());
 				}
@@ -208,7 +208,7 @@ bool SolutionVerifier<MLBPTW>::verify(const Instance<MLBPTW>& inst, const Soluti
 				}
 				ret = false;
 			}
-			else if (k > 0 && bin > 0 && usedBins[k - 1][i] < 0) {
+			else if (k > 0 && bin >= 0 && usedBins[k - 1][i] < 0) {
 				if (error_msg) {
 					std::stringstream ss;
 					ss << "Bin with id " << i << " of level " << k << " is assigned to a bin but not used.";
@@ -232,10 +232,10 @@ bool SolutionVerifier<MLBPTW>::verify(const Instance<MLBPTW>& inst, const Soluti
 			}
 		}
 		for (int bin = 0; bin < inst.n[k + 1]; bin++) {
-			if (capacity[bin] > inst.c[k + 1][bin]) {
+			if (capacity[bin] > inst.w[k + 1][bin]) {
 				if (error_msg) {
 					std::stringstream ss;
-					ss << "Bin " << bin << " of level " << k << " with capacity " << inst.c[k][bin] << " exceeds maximum capacity (" << capacity[bin] << ").";
+					ss << "Bin " << bin << " of level " << k + 1 << " with content of size " << capacity[bin] << " exceeds maximum capacity (" << inst.w[k + 1][bin] << ").";
 					MLB_OUT(TRACE) << ss.str();
 					error_msg->push_back(ss.str());
 				}
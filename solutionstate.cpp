@@ -0,0 +1,400 @@
+#include "solutionstate.h"
+
+#include "instance.h"
+#include "solution.h"
+
+#include <type_traits>
+
+
+template<typename ProbT>
+SolutionState<ProbT>::SolutionState(const Instance<ProbT>& inst, const Solution<ProbT>& sol) : inst(&inst), m(inst.m), cost(0), penalty(0), saved_penalty(0), journaling(false)
+{
+	par.assign(m, std::vector<int>());
+	pos.assign(m, std::vector<int>());
+	kids.assign(m + 1, std::vector<std::vector<int> >());
+	loads.assign(m + 1, std::vector<int>());
+	used_bins.assign(m + 1, std::vector<int>());
+	used_pos.assign(m + 1, std::vector<int>());
+	win.assign(m + 1, std::vector<Window>());
+	sorted.assign(m + 1, std::vector<int>());
+	cap.assign(m + 1, std::vector<int>());
+	rank.assign(m + 1, std::vector<int>());
+	free_bins.emplace_back(0);
+
+	for (int k : inst.M) {
+		kids[k].assign(inst.n[k], std::vector<int>());
+		loads[k].assign(inst.n[k], 0);
+		used_pos[k].assign(inst.n[k], -1);
+		if constexpr (std::is_same<ProbT, MLBPTW>::value)
+			win[k].assign(inst.n[k], empty());
+
+		sorted[k] = inst.B[k];
+		std::sort(sorted[k].begin(), sorted[k].end(), [&](int a, int b) { return inst.w[k][a] < inst.w[k][b]; });
+		cap[k].resize(inst.n[k]);
+		rank[k].resize(inst.n[k]);
+		free_bins.emplace_back(inst.n[k]);
+		for (int q = 0; q < inst.n[k]; q++) {
+			cap[k][q] = inst.w[k][sorted[k][q]];
+			rank[k][sorted[k][q]] = q;
+			free_bins[k].set(q, inst.c[k][sorted[k][q]]);
+		}
+	}
+
+	for (int k = 0; k < m; k++) {
+		par[k].assign(inst.n[k], -1);
+		pos[k].assign(inst.n[k], -1);
+		for (int x : inst.B[k]) {
+			int b = sol.item_to_bins[k][x];
+			if (b < 0)
+				continue;
+			if (used_pos[k + 1][b] < 0)
+				open(k + 1, b);
+			attach(k, x, b);
+		}
+	}
+
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		for (int k : inst.M)
+			for (int j : used_bins[k])
+				for (int c : kids[k][j])
+					win[k][j] = combine(win[k][j], window(k - 1, c));
+		for (int t : used_bins[m])
+			penalty += penaltyOf(win[m][t]);
+	}
+
+	saved_penalty = penalty;
+	journaling = true;
+}
+
+template<typename ProbT>
+int SolutionState<ProbT>::top(int k, int x) const
+{
+	for (; k < m; k++)
+		x = par[k][x];
+	return x;
+}
+
+template<typename ProbT>
+typename SolutionState<ProbT>::Window SolutionState<ProbT>::window(int k, int x) const
+{
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		if (k == 0)
+			return Window{inst->e[x], inst->l[x], 1, inst->e[x]};
+		return win[k][x];
+	}
+	return empty();
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::items(int k, int x, std::vector<int>& out) const
+{
+	if (k == 0) {
+		out.push_back(x);
+		return;
+	}
+	for (int c : kids[k][x])
+		items(k - 1, c, out);
+}
+
+template<typename ProbT>
+long SolutionState<ProbT>::penaltyOf(const Window& w) const
+{
+	if constexpr (std::is_same<ProbT, MLBPTW>::value)
+		return w.count == 0 ? 0 : (long)inst->p * (w.count * w.e - w.sum);
+	return 0;
+}
+
+template<typename ProbT>
+typename SolutionState<ProbT>::Window SolutionState<ProbT>::without(int ky, int y, const Window* add) const
+{
+	Window v = add ? *add : empty();
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		const Window& w = win[m][top(ky, y)];
+		Window wy = window(ky, y);
+		if (wy.e < w.e && wy.l > w.l)  // y does not define the window, O(depth)
+			return combine(v, Window{w.e, w.l, w.count - wy.count, w.sum - wy.sum});
+
+		for (int cur = y, k = ky; k < m; k++) {
+			int p = par[k][cur];
+			for (int c : kids[k + 1][p])
+				if (c != cur)
+					v = combine(v, window(k, c));
+			cur = p;
+		}
+	}
+	return v;
+}
+
+template<typename ProbT>
+bool SolutionState<ProbT>::relocateDelta(int k, int x, int b, long& delta) const
+{
+	int a = par[k][x];
+	if (a < 0 || a == b || used_pos[k + 1][b] < 0)
+		return false;
+	if (loads[k + 1][b] + inst->s[k][x] > inst->w[k + 1][b])
+		return false;
+
+	// bins which become empty
+	delta = 0;
+	for (int cur = a, lvl = k + 1; kids[lvl][cur].size() == 1; cur = par[lvl][cur], lvl++) {
+		delta -= inst->c[lvl][cur];
+		if (lvl == m)
+			break;
+	}
+
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		int ta = top(k + 1, a), tb = top(k + 1, b);
+		if (ta != tb) {
+			Window rest = without(k, x, nullptr);
+			Window merged = combine(win[m][tb], window(k, x));
+			if (merged.e > merged.l)
+				return false;
+			delta += penaltyOf(rest) - penaltyOf(win[m][ta]) + penaltyOf(merged) - penaltyOf(win[m][tb]);
+		}
+	}
+	return true;
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::relocate(int k, int x, int b)
+{
+	remove(k, x, true);
+	insert(k, x, b);
+}
+
+template<typename ProbT>
+bool SolutionState<ProbT>::swapDelta(int k, int x, int y, long& delta) const
+{
+	int a = par[k][x], b = par[k][y];
+	if (a < 0 || b < 0 || a == b)
+		return false;
+	if (loads[k + 1][a] - inst->s[k][x] + inst->s[k][y] > inst->w[k + 1][a])
+		return false;
+	if (loads[k + 1][b] - inst->s[k][y] + inst->s[k][x] > inst->w[k + 1][b])
+		return false;
+
+	delta = 0;
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		int ta = top(k + 1, a), tb = top(k + 1, b);
+		if (ta != tb) {
+			Window wx = window(k, x), wy = window(k, y);
+			Window na = without(k, x, &wy), nb = without(k, y, &wx);
+			if (na.e > na.l || nb.e > nb.l)
+				return false;
+			delta = penaltyOf(na) - penaltyOf(win[m][ta]) + penaltyOf(nb) - penaltyOf(win[m][tb]);
+		}
+	}
+	return true;
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::swap(int k, int x, int y)
+{
+	int a = par[k][x], b = par[k][y];
+	remove(k, x, false);
+	remove(k, y, false);
+	insert(k, x, b);
+	insert(k, y, a);
+}
+
+template<typename ProbT>
+bool SolutionState<ProbT>::exchangeDelta(int k, int j, int& r, long& delta) const
+{
+	int q = free_bins[k].argmin((int)(std::lower_bound(cap[k].begin(), cap[k].end(), loads[k][j]) - cap[k].begin()));
+	if (q < 0)
+		return false;
+	r = sorted[k][q];
+	if (k < m) {
+		int p = par[k][j];
+		if (loads[k + 1][p] - inst->s[k][j] + inst->s[k][r] > inst->w[k + 1][p])
+			return false;
+	}
+	delta = inst->c[k][r] - inst->c[k][j];
+	return true;
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::exchange(int k, int j, int r)
+{
+	open(k, r);
+	std::vector<int> content(kids[k][j]);
+	for (int c : content) {
+		detach(k - 1, c);
+		attach(k - 1, c, r);
+	}
+	if (k < m) {
+		int p = par[k][j];
+		detach(k, j);
+		attach(k, r, p);
+	}
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		setWindow(k, r, win[k][j]);
+		setWindow(k, j, empty());
+	}
+	close(k, j);
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::checkpoint()
+{
+	journal.clear();
+	saved_penalty = penalty;
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::undo()
+{
+	journaling = false;
+	for (auto it = journal.rbegin(); it != journal.rend(); ++it) {
+		switch (it->type) {
+			case Change::Attach:    detach(it->k, it->x); break;
+			case Change::Detach:    attach(it->k, it->x, it->b); break;
+			case Change::Open:      close(it->k, it->x); break;
+			case Change::Close:     open(it->k, it->x); break;
+			case Change::SetWindow: win[it->k][it->x] = it->w; break;
+		}
+	}
+	journal.clear();
+	penalty = saved_penalty;
+	journaling = true;
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::extract(Solution<ProbT>& sol) const
+{
+	sol.total_bins = 0;
+	for (int k = 0; k < m; k++)
+		sol.item_to_bins[k] = par[k];
+	for (int k = 1; k <= m; k++)
+		sol.total_bins += (int)used_bins[k].size();
+	sol.total_cost = (int)objective();
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::remove(int k, int x, bool closing)
+{
+	int a = par[k][x];
+	int t = top(k + 1, a);
+	Window wx = window(k, x);
+	addPenalty(t, -1);
+	detach(k, x);
+
+	for (int cur = a, lvl = k + 1; ; lvl++) {
+		int p = lvl < m ? par[lvl][cur] : -1;
+		if (kids[lvl][cur].empty() && closing) {
+			// the bin is closed and removed from its parent
+			if constexpr (std::is_same<ProbT, MLBPTW>::value)
+				setWindow(lvl, cur, empty());
+			close(lvl, cur);
+			if (lvl == m)
+				return;
+			detach(lvl, cur);
+		} else {
+			if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+				const Window& w = win[lvl][cur];
+				if (kids[lvl][cur].empty())
+					setWindow(lvl, cur, empty());
+				else if (wx.e < w.e && wx.l > w.l)
+					setWindow(lvl, cur, Window{w.e, w.l, w.count - wx.count, w.sum - wx.sum});
+				else {
+					// x defined the window, recompute from the children
+					Window v = empty();
+					for (int c : kids[lvl][cur])
+						v = combine(v, window(lvl - 1, c));
+					setWindow(lvl, cur, v);
+				}
+			}
+			if (lvl == m)
+				break;
+		}
+		cur = p;
+	}
+	addPenalty(t, 1);
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::insert(int k, int x, int b)
+{
+	int t = top(k + 1, b);
+	addPenalty(t, -1);
+	attach(k, x, b);
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		Window wx = window(k, x);
+		for (int cur = b, lvl = k + 1; ; cur = par[lvl][cur], lvl++) {
+			setWindow(lvl, cur, combine(win[lvl][cur], wx));
+			if (lvl == m)
+				break;
+		}
+	}
+	addPenalty(t, 1);
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::addPenalty(int t, long sign)
+{
+	if constexpr (std::is_same<ProbT, MLBPTW>::value)
+		penalty += sign * penaltyOf(win[m][t]);
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::attach(int k, int x, int b)
+{
+	par[k][x] = b;
+	pos[k][x] = (int)kids[k + 1][b].size();
+	kids[k + 1][b].push_back(x);
+	loads[k + 1][b] += inst->s[k][x];
+	if (journaling)
+		journal.push_back(Change{Change::Attach, k, x, b, empty()});
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::detach(int k, int x)
+{
+	int b = par[k][x];
+	std::vector<int>& content = kids[k + 1][b];
+	int last = content.back();
+	content[pos[k][x]] = last;
+	pos[k][last] = pos[k][x];
+	content.pop_back();
+	loads[k + 1][b] -= inst->s[k][x];
+	par[k][x] = -1;
+	if (journaling)
+		journal.push_back(Change{Change::Detach, k, x, b, empty()});
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::open(int k, int j)
+{
+	used_pos[k][j] = (int)used_bins[k].size();
+	used_bins[k].push_back(j);
+	free_bins[k].remove(rank[k][j]);
+	cost += inst->c[k][j];
+	if (journaling)
+		journal.push_back(Change{Change::Open, k, j, -1, empty()});
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::close(int k, int j)
+{
+	int last = used_bins[k].back();
+	used_bins[k][used_pos[k][j]] = last;
+	used_pos[k][last] = used_pos[k][j];
+	used_bins[k].pop_back();
+	used_pos[k][j] = -1;
+	free_bins[k].set(rank[k][j], inst->c[k][j]);
+	cost -= inst->c[k][j];
+	if (journaling)
+		journal.push_back(Change{Change::Close, k, j, -1, empty()});
+}
+
+template<typename ProbT>
+void SolutionState<ProbT>::setWindow(int k, int j, const Window& w)
+{
+	if (journaling)
+		journal.push_back(Change{Change::SetWindow, k, j, -1, win[k][j]});
+	win[k][j] = w;
+}
+
+// Instantiate all required solution state classes
+template class SolutionState<MLBP>;
+template class SolutionState<MLBPTW>;
@@ -0,0 +1,131 @@
+#ifndef __SOLUTION_STATE_H__
+#define __SOLUTION_STATE_H__
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+#include "problems.h"
+#include "segmenttree.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+
+/**
+ * Mutable representation of a feasible MLBP/MLBPTW solution for local search.
+ * In contrast to Solution (only item_to_bins) it caches:
+ *
+ *  *) par, kids  -> bin of each element and content of each bin (child count = kids[k][j].size())
+ *  *) loads      -> load of each bin
+ *  *) used       -> used bins of each level and the cheapest unused bin for a given load (segment tree)
+ *  *) win        -> time windows of each subtree [max e, min l] with number of items and sum of e (only MLBPTW)
+ *  *) objective  -> cost of the used bins plus the waiting penalty of the top-level bins
+ *
+ *  Moves are evaluated without modifying the state (xxxDelta) in O(depth) for capacities and the
+ *  closed bins. The time windows are updated in O(depth) as long as the moved element does not define
+ *  max e or min l of a bin, otherwise the bins on its path are recomputed from their children.
+ *  Applied moves are journaled, undo() restores the state of the last checkpoint().
+ *  A bin becoming empty is closed, which cascades upwards if its parent becomes empty.
+ */
+template<typename ProbT>
+class SolutionState
+{
+public:
+	// time windows of a subtree: max e, min l, number of items and sum of e
+	struct Window
+	{
+		int e;
+		int l;
+		long count;
+		long sum;
+	};
+
+	static Window combine(const Window& a, const Window& b)
+	{
+		return Window{std::max(a.e, b.e), std::min(a.l, b.l), a.count + b.count, a.sum + b.sum};
+	}
+	static Window empty() { return Window{INT_MIN, INT_MAX, 0, 0}; }
+
+	SolutionState(const Instance<ProbT>& inst, const Solution<ProbT>& sol);
+
+	const Instance<ProbT>& instance() const { return *inst; }
+	long objective() const { return cost + penalty; }
+
+	int parent(int k, int x) const { return par[k][x]; }                     // bin of level k+1 containing x, -1: unused
+	int load(int k, int j) const { return loads[k][j]; }
+	bool isUsed(int k, int j) const { return used_pos[k][j] >= 0; }
+	const std::vector<int>& used(int k) const { return used_bins[k]; }      // used bins of level k >= 1
+	const std::vector<int>& children(int k, int j) const { return kids[k][j]; }
+
+	int elements(int k) const { return k == 0 ? (int)par[0].size() : (int)used_bins[k].size(); }  // number of used items/bins of level k
+	int element(int k, int q) const { return k == 0 ? q : used_bins[k][q]; }                      // q-th used item/bin of level k
+	int top(int k, int x) const;
+	Window window(int k, int x) const;
+	void items(int k, int x, std::vector<int>& out) const;  // items of the subtree of x
+
+	// move x of level k into the used bin b of level k+1
+	bool relocateDelta(int k, int x, int b, long& delta) const;
+	void relocate(int k, int x, int b);
+
+	// exchange x and y of level k
+	bool swapDelta(int k, int x, int y, long& delta) const;
+	void swap(int k, int x, int y);
+
+	// replace the used bin j of level k >= 1 by the cheapest unused bin r holding its content
+	bool exchangeDelta(int k, int j, int& r, long& delta) const;
+	void exchange(int k, int j, int r);
+
+	// window of the top-level bin of y (level ky) without the subtree of y, optionally extended by add
+	Window without(int ky, int y, const Window* add) const;
+	long penaltyOf(const Window& w) const;
+
+	void checkpoint();  // clears the journal
+	void undo();        // reverts all moves since the last checkpoint
+
+	void extract(Solution<ProbT>& sol) const;
+
+private:
+	// journaled modifications
+	struct Change
+	{
+		enum Type { Attach, Detach, Open, Close, SetWindow };
+		Type type;
+		int k;
+		int x;
+		int b;
+		Window w;
+	};
+
+	void attach(int k, int x, int b);
+	void detach(int k, int x);
+	void open(int k, int j);
+	void close(int k, int j);
+	void setWindow(int k, int j, const Window& w);
+	void remove(int k, int x, bool closing);  // detaches x (level k), closing: the bins becoming empty are closed; updates the windows
+	void insert(int k, int x, int b);  // attaches x (level k) to b, updates the windows
+	void addPenalty(int top, long sign);
+
+	const Instance<ProbT>* inst;
+	int m;
+
+	std::vector<std::vector<int> > par;                 // par[k][x]: bin of level k+1 containing x, -1: unused
+	std::vector<std::vector<int> > pos;                 // pos[k][x]: position of x in kids[k+1][par[k][x]]
+	std::vector<std::vector<std::vector<int> > > kids;  // kids[k][j]: content of bin j of level k
+	std::vector<std::vector<int> > loads;
+	std::vector<std::vector<int> > used_bins;
+	std::vector<std::vector<int> > used_pos;            // position in used_bins, -1: unused
+	std::vector<std::vector<Window> > win;              // only MLBPTW
+
+	// unused bins of each level sorted by capacity, keyed by cost
+	std::vector<std::vector<int> > sorted, cap, rank;
+	std::vector<MinTree> free_bins;
+
+	long cost;
+	long penalty;
+
+	std::vector<Change> journal;
+	long saved_penalty;
+	bool journaling;
+};
+
+#endif // __SOLUTION_STATE_H__
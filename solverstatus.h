@@ -0,0 +1,20 @@
+#ifndef __SOLVER_STATUS_H__
+#define __SOLVER_STATUS_H__
+
+/**
+ * Result status shared by all solvers (MIP based and native).
+ * Solvers derive from this struct such that the status values can be
+ * accessed as e.g. MIPSolver<BP>::Optimal.
+ */
+struct SolverStatus
+{
+	enum Status
+	{
+		Optimal,     // Returned solution is proven optimal
+		Feasible,    // Returned solution is feasible
+		Infeasible,  // Instance is infeasible
+		Aborted      // There is no feasible solution due to time limits or memeory limits
+	};
+};
+
+#endif // __SOLVER_STATUS_H__
@@ -0,0 +1,127 @@
+/**
+ * Regression tests of the bin completion solver for the Bin Packing Problem (BPSolver).
+ *
+ *  *) zero sizes -> items of size 0 must not make the reduction fix bins or the bounds overshoot the optimum
+ *  *) random     -> the number of bins and the dual bound are compared with an exhaustive search on small
+ *                   random instances, with and without items of size 0
+ *  *) time limit -> many small items next to medium ones give a huge number of completions, the time limit
+ *                   must also stop their generation
+ *
+ * Build from the repository root (needs lib/):
+ *   g++ -std=c++17 -O2 -I. -o bpsolver_test tests/bpsolver_test.cpp bpsolver.cpp instance.cpp solution.cpp solution_verifier.cpp
+ */
+#include "bpsolver.h"
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what, const std::vector<int>& sizes, int capacity)
+{
+	if (condition)
+		return;
+	failures++;
+	std::printf("FAILED: %s, capacity %d, sizes", what, capacity);
+	for (int s : sizes)
+		std::printf(" %d", s);
+	std::printf("\n");
+}
+
+// minimum number of bins by dynamic programming over the subsets of items
+int optimum(const std::vector<int>& sizes, int capacity)
+{
+	const int n = (int)sizes.size();
+	const int full = (1 << n) - 1;
+	std::vector<int> load(full + 1, 0), bins(full + 1, n + 1);
+	for (int mask = 1; mask <= full; mask++) {
+		int i = __builtin_ctz(mask);
+		load[mask] = load[mask & (mask - 1)] + sizes[i];
+	}
+	bins[0] = 0;
+	for (int mask = 1; mask <= full; mask++) {
+		// the bin of the lowest item of mask holds a subset of mask
+		int low = mask & -mask;
+		for (int sub = mask; sub > 0; sub = (sub - 1) & mask)
+			if ((sub & low) && load[sub] <= capacity)
+				bins[mask] = std::min(bins[mask], bins[mask ^ sub] + 1);
+	}
+	return bins[full];
+}
+
+void solve(const std::vector<int>& sizes, int capacity, int expected)
+{
+	Instance<BP> inst(sizes, capacity);
+	Solution<BP> sol(inst);
+	BPSolver solver;
+	BPSolver::Status status = solver.run(inst, sol);
+	check(status == BPSolver::Optimal, "status Optimal", sizes, capacity);
+	check(SolutionVerifier<BP>::verify(inst, sol), "feasible solution", sizes, capacity);
+	check(sol.total_bins == expected, "optimal number of bins", sizes, capacity);
+	check(sol.db <= expected, "dual bound at most the optimum", sizes, capacity);
+	check(BPSolver::lowerBoundL3(sizes, capacity) <= expected, "L3 at most the optimum", sizes, capacity);
+}
+
+// 30 medium and 40 small items, the bin of a medium item has a huge number of completions by small items
+void limited(int seed, int time_limit)
+{
+	const int capacity = 100000;
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> medium(capacity / 6.0, capacity / 2.0), small(capacity / 300.0, capacity / 300.0 + capacity / 60.0);
+	std::vector<int> sizes;
+	for (int t = 0; t < 30; t++)
+		sizes.push_back((int)medium(rng));
+	for (int t = 0; t < 40; t++)
+		sizes.push_back((int)small(rng));
+
+	Instance<BP> inst(sizes, capacity);
+	Solution<BP> sol(inst);
+	BPSolver solver;
+	solver.setTimeLimit(time_limit);
+	auto start = std::chrono::steady_clock::now();
+	BPSolver::Status status = solver.run(inst, sol);
+	std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+	check(d.count() < time_limit + 1.0, "time limit", sizes, capacity);
+	check(status == BPSolver::Optimal || status == BPSolver::Feasible, "status Optimal or Feasible", sizes, capacity);
+	check(SolutionVerifier<BP>::verify(inst, sol), "feasible solution", sizes, capacity);
+	check(sol.db <= sol.total_bins, "dual bound at most the number of bins", sizes, capacity);
+}
+
+} // namespace
+
+int main()
+{
+	// reduction fixed {5} alone and {3, 2} although {3, 2, 0} and {5, 3, 2} fit: 3 bins reported as optimal
+	solve({3, 3, 5, 4, 3, 2, 0}, 10, 2);
+	solve({0, 0, 0}, 10, 1);
+	solve({10, 0}, 10, 1);
+
+	std::mt19937 rng(1);
+	for (int round = 0; round < 2000; round++) {
+		const int n = 1 + rng() % 10, capacity = 5 + rng() % 20;
+		std::vector<int> sizes(n);
+		for (int& s : sizes)
+			s = rng() % 4 == 0 ? 0 : 1 + rng() % capacity;
+		solve(sizes, capacity, optimum(sizes, capacity));
+	}
+
+	// the generation of the first completions did not stop for minutes on these seeds
+	for (int seed : {10, 11, 23, 34, 41})
+		limited(seed, 2);
+
+	if (failures > 0) {
+		std::printf("%d checks failed\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::printf("all checks passed\n");
+	return EXIT_SUCCESS;
+}
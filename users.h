@@ -93,6 +93,24 @@ CREATE_USER(MIP, logging::NoCol, 0);
 #define MIP_OUT(verbosity) if (false) user::null_logger<user::MIP>()
 #endif
 
+// Lagrangian Relaxation
+#if defined(USER_LR) && (USER_LR > 0)
+CREATE_USER(LR, logging::Green, USER_LR);
+#define LR_OUT(verbosity) if (true) user::dec_logger<user::LR>(verbosity)
+#else
+CREATE_USER(LR, logging::NoCol, 0);
+#define LR_OUT(verbosity) if (false) user::null_logger<user::LR>()
+#endif
+
+// Native heuristics and metaheuristics
+#if defined(USER_HEU) && (USER_HEU > 0)
+CREATE_USER(HEU, logging::Blue, USER_HEU);
+#define HEU_OUT(verbosity) if (true) user::dec_logger<user::HEU>(verbosity)
+#else
+CREATE_USER(HEU, logging::NoCol, 0);
+#define HEU_OUT(verbosity) if (false) user::null_logger<user::HEU>()
+#endif
+
 // Define your own user here
  #if defined(USER_MLB) && (USER_MLB > 0)
  CREATE_USER(MLB, logging::Blue, USER_MLB);
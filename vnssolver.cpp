@@ -0,0 +1,336 @@
+#include "vnssolver.h"
+
+#include "instance.h"
+#include "solution.h"
+#include "solution_verifier.h"
+#include "users.h"
+#include "solutionstate.h"
+
+#include <climits>
+#include <type_traits>
+#include <unordered_map>
+
+
+/*****************************************************************************************/
+/** Variable Neighbourhood Search ********************************************************/
+/*****************************************************************************************/
+
+// redistributes the content of the used bin j of level k into other used bins of level k;
+// moves: (child, target), returns false if some child does not fit
+template<typename ProbT>
+static bool closeDelta(const SolutionState<ProbT>& state, const Instance<ProbT>& inst, int k, int j, int candidates, std::mt19937& rng,
+                       std::vector<std::pair<int, int> >& moves, long& delta)
+{
+	typedef typename SolutionState<ProbT>::Window Window;
+	const std::vector<int>& targets = state.used(k);
+	if (targets.size() < 2)
+		return false;
+
+	moves.clear();
+	std::unordered_map<int, int> extra;       // additional load of the targets
+	std::unordered_map<int, Window> joined;   // additional content of the target top-level bins
+	const int t_j = state.top(k, j);
+
+	// largest content first, best fit among the sampled targets
+	std::vector<int> content(state.children(k, j));
+	std::sort(content.begin(), content.end(), [&](int a, int b) { return inst.s[k - 1][a] > inst.s[k - 1][b]; });
+	for (int c : content) {
+		int best = -1, best_residual = INT_MAX;
+		for (int t = 0; t < candidates; t++) {
+			int b = targets[rng() % targets.size()];
+			if (b == j)
+				continue;
+			int residual = inst.w[k][b] - state.load(k, b) - extra[b] - inst.s[k - 1][c];
+			if (residual < 0 || residual >= best_residual)
+				continue;
+			if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+				int tb = state.top(k, b);
+				Window w = tb == t_j ? state.without(k, j, nullptr) : state.window(inst.m, tb);
+				auto it = joined.find(tb);
+				if (it != joined.end())
+					w = SolutionState<ProbT>::combine(w, it->second);
+				Window wc = state.window(k - 1, c);
+				if (std::max(w.e, wc.e) > std::min(w.l, wc.l))
+					continue;
+			}
+			best = b;
+			best_residual = residual;
+		}
+		if (best < 0)
+			return false;
+
+		moves.push_back(std::make_pair(c, best));
+		extra[best] += inst.s[k - 1][c];
+		if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+			Window wc = state.window(k - 1, c);
+			auto it = joined.find(state.top(k, best));
+			if (it == joined.end())
+				joined.emplace(state.top(k, best), wc);
+			else
+				it->second = SolutionState<ProbT>::combine(it->second, wc);
+		}
+	}
+
+	// j and its ancestors which become empty are closed
+	delta = 0;
+	for (int cur = j, lvl = k; ; cur = state.parent(lvl, cur), lvl++) {
+		delta -= inst.c[lvl][cur];
+		if (lvl == inst.m || state.children(lvl + 1, state.parent(lvl, cur)).size() > 1)
+			break;
+	}
+
+	if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+		bool own = joined.count(t_j) > 0;
+		if (!own)
+			delta += state.penaltyOf(state.without(k, j, nullptr)) - state.penaltyOf(state.window(inst.m, t_j));
+		for (const auto& entry : joined) {
+			Window base = entry.first == t_j ? state.without(k, j, nullptr) : state.window(inst.m, entry.first);
+			Window w = SolutionState<ProbT>::combine(base, entry.second);
+			delta += state.penaltyOf(w) - state.penaltyOf(state.window(inst.m, entry.first));
+		}
+	}
+	return true;
+}
+
+template<typename ProbT>
+bool VNSSolver<ProbT>::timeout() const
+{
+	std::chrono::duration<double> d = std::chrono::steady_clock::now() - m_start;
+	return m_time_limit > 0 && d.count() >= m_time_limit;
+}
+
+template<typename ProbT>
+typename VNSSolver<ProbT>::Status VNSSolver<ProbT>::run(const Instance<ProbT>& inst, Solution<ProbT>& sol)
+{
+	m_start = std::chrono::steady_clock::now();
+	m_iterations = 0;
+
+	if (!SolutionVerifier<ProbT>::verify(inst, sol)) {
+		HEU_OUT(WARN) << "VNS needs a feasible start solution" << std::endl;
+		return Aborted;
+	}
+
+	std::mt19937 rng(m_seed);
+	SolutionState<ProbT> state(inst, sol);
+	long best = state.objective();
+
+	localSearch(state, rng);
+	if (state.objective() < best) {
+		best = state.objective();
+		state.extract(sol);
+	}
+	HEU_OUT(DBG) << "VNS: local optimum " << best << std::endl;
+	state.checkpoint();
+
+	int k = 1;
+	while (!timeout() && (m_iteration_limit == 0 || m_iterations < m_iteration_limit)) {
+		if (sol.total_cost <= sol.db)
+			break;
+
+		shake(state, k, rng);
+		localSearch(state, rng);
+		m_iterations++;
+
+		if (state.objective() < best) {
+			best = state.objective();
+			state.extract(sol);
+			state.checkpoint();
+			k = 1;
+			HEU_OUT(DBG) << "VNS iteration " << m_iterations << ": improved objective value to " << best << std::endl;
+		} else {
+			state.undo();  // continue from the best solution
+			k = k % m_max_shake + 1;
+		}
+	}
+
+	HEU_OUT(DBG) << "VNS: " << m_iterations << " iterations, objective value " << sol.total_cost << std::endl;
+	return sol.total_cost <= sol.db ? Optimal : Feasible;
+}
+
+template<typename ProbT>
+void VNSSolver<ProbT>::localSearch(SolutionState<ProbT>& state, std::mt19937& rng) const
+{
+	const Instance<ProbT>& inst = state.instance();
+	const int m = inst.m;
+	std::vector<int> order;
+	std::vector<std::pair<int, int> > moves, best_moves;
+	int counter = 0;
+
+	for (bool improved = true; improved; ) {
+		improved = false;
+
+		// close: empty a used bin into the other bins of its level
+		for (int k = m; k >= 1; k--) {
+			order = state.used(k);
+			std::shuffle(order.begin(), order.end(), rng);
+			for (int j : order) {
+				if ((++counter & 63) == 0 && timeout())
+					return;
+				long delta;
+				if (!state.isUsed(k, j))
+					continue;  // closed meanwhile
+				if (closeDelta(state, inst, k, j, m_candidates, rng, moves, delta) && delta < 0) {
+					for (const auto& move : moves)
+						state.relocate(k - 1, move.first, move.second);
+					improved = true;
+				}
+			}
+		}
+
+		// relocate and swap
+		for (int k = 0; k < m; k++) {
+			order.clear();
+			for (int q = 0; q < state.elements(k); q++)
+				order.push_back(state.element(k, q));
+			std::shuffle(order.begin(), order.end(), rng);
+			for (int x : order) {
+				if ((++counter & 255) == 0 && timeout())
+					return;
+				if (state.parent(k, x) < 0)
+					continue;
+
+				long best = 0, delta;
+				int target = -1;
+				bool swap = false;
+				const std::vector<int>& targets = state.used(k + 1);
+				for (int t = 0; t < m_candidates; t++) {
+					int b = targets[rng() % targets.size()];
+					if (state.relocateDelta(k, x, b, delta) && delta < best) {
+						best = delta;
+						target = b;
+						swap = false;
+					}
+				}
+				if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+					for (int t = 0; t < m_candidates; t++) {
+						int y = state.element(k, rng() % state.elements(k));
+						if (state.swapDelta(k, x, y, delta) && delta < best) {
+							best = delta;
+							target = y;
+							swap = true;
+						}
+					}
+				}
+				if (target < 0)
+					continue;
+				if (swap)
+					state.swap(k, x, target);
+				else
+					state.relocate(k, x, target);
+				improved = true;
+			}
+		}
+
+		// exchange: cheaper bins for the same content
+		for (int k = 1; k <= m; k++) {
+			order = state.used(k);
+			for (int j : order) {
+				int r;
+				long delta;
+				if (state.isUsed(k, j) && state.exchangeDelta(k, j, r, delta) && delta < 0) {
+					state.exchange(k, j, r);
+					improved = true;
+				}
+			}
+		}
+
+		// retime: move the items defining the start of a top-level bin into another top-level bin
+		if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+			std::vector<int> content;
+			order = state.used(m);
+			for (int t : order) {
+				if ((++counter & 63) == 0 && timeout())
+					return;
+				if (!state.isUsed(m, t))
+					continue;
+				int start = state.window(m, t).e;
+				content.clear();
+				state.items(m, t, content);
+				for (int i : content) {
+					if (inst.e[i] != start)
+						continue;
+					long best = 0, delta;
+					int target = -1;
+					const std::vector<int>& targets = state.used(1);
+					for (int q = 0; q < m_candidates; q++) {
+						int b = targets[rng() % targets.size()];
+						if (state.relocateDelta(0, i, b, delta) && delta < best) {
+							best = delta;
+							target = b;
+						}
+					}
+					if (target >= 0) {
+						state.relocate(0, i, target);
+						improved = true;
+						break;
+					}
+				}
+			}
+		}
+
+		if (timeout())
+			return;
+	}
+}
+
+template<typename ProbT>
+void VNSSolver<ProbT>::shake(SolutionState<ProbT>& state, int k, std::mt19937& rng) const
+{
+	const Instance<ProbT>& inst = state.instance();
+	const int m = inst.m;
+	std::vector<std::pair<int, int> > moves;
+	const int types = std::is_same<ProbT, MLBPTW>::value ? 4 : 3;
+
+	for (int move = 0; move < k; move++) {
+		int type = rng() % types;
+		long delta;
+		for (int attempt = 0; attempt < m_candidates; attempt++) {
+			if (type == 0) {
+				// relocate
+				int level = rng() % m;
+				int x = state.element(level, rng() % state.elements(level));
+				int b = state.used(level + 1)[rng() % state.used(level + 1).size()];
+				if (state.relocateDelta(level, x, b, delta)) {
+					state.relocate(level, x, b);
+					break;
+				}
+			} else if (type == 1) {
+				// swap
+				int level = rng() % m;
+				int x = state.element(level, rng() % state.elements(level));
+				int y = state.element(level, rng() % state.elements(level));
+				if (state.swapDelta(level, x, y, delta)) {
+					state.swap(level, x, y);
+					break;
+				}
+			} else if (type == 2) {
+				// close
+				int level = 1 + rng() % m;
+				int j = state.used(level)[rng() % state.used(level).size()];
+				if (closeDelta(state, inst, level, j, m_candidates, rng, moves, delta)) {
+					for (const auto& mv : moves)
+						state.relocate(level - 1, mv.first, mv.second);
+					break;
+				}
+			} else if constexpr (std::is_same<ProbT, MLBPTW>::value) {
+				// retime: the item defining the start of a random top-level bin is moved elsewhere
+				int t = state.used(m)[rng() % state.used(m).size()];
+				std::vector<int> content;
+				state.items(m, t, content);
+				int i = content[0];
+				for (int c : content)
+					if (inst.e[c] > inst.e[i])
+						i = c;
+				int b = state.used(1)[rng() % state.used(1).size()];
+				if (state.relocateDelta(0, i, b, delta)) {
+					state.relocate(0, i, b);
+					break;
+				}
+			}
+		}
+	}
+}
+
+// Instantiate all required VNS solver classes
+template class VNSSolver<MLBP>;
+template class VNSSolver<MLBPTW>;
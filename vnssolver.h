@@ -0,0 +1,67 @@
+#ifndef __VNS_SOLVER_H__
+#define __VNS_SOLVER_H__
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+
+#include "problems.h"
+#include "solverstatus.h"
+
+template<typename> struct Instance;
+template<typename> struct Solution;
+template<typename> class SolutionState;
+
+/**
+ * Variable Neighbourhood Search which improves a feasible solution without CPLEX.
+ * Works directly on item_to_bins, all moves are evaluated incrementally (see SolutionState):
+ *
+ *  *) relocate -> item/bin of level k is moved into another used bin of level k+1 (moving a bin moves its subtree)
+ *  *) swap     -> two items/bins of the same level in different bins are exchanged
+ *  *) exchange -> a used bin is replaced by the cheapest unused bin holding its content
+ *  *) close    -> the content of a used bin is redistributed into the other used bins of its level
+ *  *) retime   -> an item defining the start time of its top-level bin is moved into another top-level bin (only MLBPTW)
+ *
+ *  The local search applies the best improving move among a sample of candidate targets for each
+ *  element until no improvement is found. Shaking applies k random feasible moves, k grows from 1
+ *  to the maximum shaking size if the local search does not find a better solution and is reset to 1
+ *  otherwise. Non-improving solutions are rejected, i.e. the search continues from the best solution.
+ *  The search is reproducible for a given seed and iteration limit.
+ */
+template<typename ProbT>
+class VNSSolver : public SolverStatus
+{
+public:
+	VNSSolver() : m_time_limit(60), m_iteration_limit(0), m_seed(0), m_candidates(16), m_max_shake(8), m_iterations(0) { }
+
+	void setTimeLimit(int time) { m_time_limit = time; }              // in seconds -> 0: no time limit
+	void setIterationLimit(int number) { m_iteration_limit = number; } // 0: no iteration limit
+	void setSeed(unsigned int seed) { m_seed = seed; }
+	void setCandidates(int number) { m_candidates = std::max(1, number); }  // number of sampled targets per element and move
+	void setMaxShake(int number) { m_max_shake = std::max(1, number); }     // maximum number of random moves per shaking
+
+	// improves the feasible solution sol
+	Status run(const Instance<ProbT>& inst, Solution<ProbT>& sol);
+
+	int iterations() const { return m_iterations; }  // number of VNS iterations from last run(...) call
+
+private:
+	// applies improving moves until a local optimum (or the time limit) is reached
+	void localSearch(SolutionState<ProbT>& state, std::mt19937& rng) const;
+
+	// applies k random feasible moves
+	void shake(SolutionState<ProbT>& state, int k, std::mt19937& rng) const;
+
+	bool timeout() const;
+
+	int m_time_limit;
+	int m_iteration_limit;
+	unsigned int m_seed;
+	int m_candidates;
+	int m_max_shake;
+	int m_iterations;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // __VNS_SOLVER_H__